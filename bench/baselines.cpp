@@ -0,0 +1,168 @@
+/// Baseline comparison: every vx::func preset against the common alternatives
+/// (template-inlined callable, function_ref, virtual interface, std::variant, std::function)
+/// for construct / invoke / move / destroy across closure sizes 0-256 bytes.
+///
+///   g++ -std=c++20 -O2 baselines.cpp -o baselines && ./baselines > baselines.csv
+///   (-std=c++23 adds std::move_only_function where the library has it)
+///
+/// Output is CSV, one row per implementation and closure size, times in ns per operation.
+/// Every operation runs over a batch of objects stored in a std::vector, as a callback list would.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "../func.hpp"
+#include "baselines.hpp"
+
+namespace {
+
+constexpr std::size_t batch = 1024;
+constexpr std::size_t rounds = 200;
+
+template <std::size_t Bytes>
+struct closure {
+    explicit closure(std::uint64_t seed) { state.fill(seed); }
+
+    std::uint64_t operator()(std::uint64_t x) noexcept {
+        state.front() += x;
+        return state.front() ^ state.back();
+    }
+
+    std::array<std::uint64_t, Bytes / 8> state;
+};
+
+template <>
+struct closure<0> {
+    explicit closure(std::uint64_t) {}
+    std::uint64_t operator()(std::uint64_t x) const noexcept { return x * 3 + 1; }
+};
+
+/// Second alternative for the closed-set implementations
+struct other {
+    std::uint64_t k = 1;
+    std::uint64_t operator()(std::uint64_t x) const noexcept { return x + k; }
+};
+
+using signature = std::uint64_t(std::uint64_t);
+
+namespace presets {
+
+inline constexpr vx::cfg::function standard = {};
+
+inline constexpr vx::cfg::function no_fptr = {
+    .optimize_for_func_ptrs = false
+};
+
+inline constexpr vx::cfg::function checked = {
+    .check_empty = true
+};
+
+inline constexpr vx::cfg::function trivial = {
+    .trivial_abi = true
+};
+
+template <std::size_t Bytes>
+inline constexpr vx::cfg::function inplace = {
+    .SBO = std::max(Bytes, std::size_t{8}),
+    .alignment = 8,
+    .allow_heap = false
+};
+
+} // namespace presets
+
+struct result {
+    double construct = 0, invoke = 0, move = 0, destroy = 0;
+};
+
+std::uint64_t sink = 0;
+
+template <typename Body>
+double elapsed_ns(Body&& body) {
+    const auto t0 = std::chrono::steady_clock::now();
+    body();
+    const auto t1 = std::chrono::steady_clock::now();
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+}
+
+/// W is constructed from a closure prvalue, or from the closure lvalue for non-owning references
+template <typename W, std::size_t Bytes>
+result measure(std::vector<closure<Bytes>>& sources) {
+    constexpr bool by_reference = std::is_constructible_v<W, closure<Bytes>&> && !std::is_constructible_v<W, closure<Bytes>&&>;
+
+    std::vector<W> live, moved;
+    live.reserve(batch);
+    moved.reserve(batch);
+
+    result r;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        r.construct += elapsed_ns([&]{
+            for (auto& source : sources) {
+                if constexpr (by_reference) { live.emplace_back(source); }
+                else { live.emplace_back(closure<Bytes>{source}); }
+            }
+        });
+        r.invoke += elapsed_ns([&]{
+            std::uint64_t acc = 0;
+            for (auto& w : live) { acc += w(round); }
+            sink += acc;
+        });
+        r.move += elapsed_ns([&]{
+            for (auto& w : live) { moved.emplace_back(std::move(w)); }
+        });
+        r.destroy += elapsed_ns([&]{ moved.clear(); });
+        live.clear();
+    }
+
+    const double ops = double(batch * rounds);
+    return { r.construct / ops, r.invoke / ops, r.move / ops, r.destroy / ops };
+}
+
+template <typename W, std::size_t Bytes>
+void row(const char * name, std::vector<closure<Bytes>>& sources) {
+    const auto r = measure<W>(sources);
+    std::printf("%s,%zu,%.3f,%.3f,%.3f,%.3f\n", name, sizeof(closure<Bytes>), r.construct, r.invoke, r.move, r.destroy);
+}
+
+template <std::size_t Bytes>
+void run_size() {
+    using F = closure<Bytes>;
+    namespace baseline = vx::bench::baseline;
+
+    std::vector<F> sources;
+    sources.reserve(batch);
+    for (std::size_t i = 0; i < batch; ++i) { sources.emplace_back(i); }
+
+    row<F>("inlined", sources);
+    row<baseline::function_ref<signature>>("function_ref", sources);
+    row<baseline::virtual_func<signature>>("virtual_unique_ptr", sources);
+    row<baseline::variant_func<signature, F, other>>("std_variant_visit", sources);
+    row<std::function<signature>>("std_function", sources);
+#if defined __cpp_lib_move_only_function
+    row<std::move_only_function<signature>>("std_move_only_function", sources);
+#endif
+    row<vx::func<signature, presets::standard>>("vx_func", sources);
+    row<vx::move_only_func<signature>>("vx_move_only_func", sources);
+    row<vx::func<signature, presets::inplace<Bytes>>>("vx_func_inplace", sources);
+    row<vx::func<signature, presets::no_fptr>>("vx_func_no_fptr", sources);
+    row<vx::func<signature, presets::checked>>("vx_func_check_empty", sources);
+    row<vx::func<signature, presets::trivial>>("vx_func_trivial_abi", sources);
+    row<vx::func_variant<signature, F, other>>("vx_func_variant", sources);
+}
+
+} // namespace
+
+int main() {
+    std::printf("impl,closure_bytes,construct_ns,invoke_ns,move_ns,destroy_ns\n");
+    run_size<0>();
+    run_size<8>();
+    run_size<16>();
+    run_size<32>();
+    run_size<64>();
+    run_size<128>();
+    run_size<256>();
+    std::fprintf(stderr, "(checksum %llu)\n", static_cast<unsigned long long>(sink));
+}
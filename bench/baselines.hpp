@@ -0,0 +1,85 @@
+#pragma once
+
+/// Reference implementations of the usual alternatives to vx::func, kept minimal on purpose
+/// so the benchmarks compare abstractions rather than library quality.
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace vx::bench::baseline {
+
+/// Classic OOP erasure: heap-allocated object behind a virtual interface
+template <typename Signature>
+class virtual_func;
+
+template <typename R, typename... Args>
+class virtual_func<R(Args...)> {
+    struct iface {
+        virtual ~iface() = default;
+        virtual R invoke(Args... args) = 0;
+    };
+
+    template <typename F>
+    struct impl final : iface {
+        explicit impl(F f) : f{ std::move(f) } {}
+        R invoke(Args... args) override { return f(std::forward<Args>(args)...); }
+        F f;
+    };
+
+public:
+    template <typename F>
+    virtual_func(F f) requires (!std::is_same_v<F, virtual_func>)
+    : ptr{ std::make_unique<impl<F>>(std::move(f)) }
+    {}
+
+    R operator() (Args... args) { return ptr->invoke(std::forward<Args>(args)...); }
+
+private:
+    std::unique_ptr<iface> ptr;
+};
+
+
+/// Closed set of alternatives dispatched with std::visit
+template <typename Signature, typename... Fs>
+class variant_func;
+
+template <typename R, typename... Args, typename... Fs>
+class variant_func<R(Args...), Fs...> {
+public:
+    template <typename F>
+    variant_func(F f) requires (!std::is_same_v<F, variant_func>)
+    : alternatives{ std::move(f) }
+    {}
+
+    R operator() (Args... args) {
+        return std::visit([&](auto& f) -> R { return f(std::forward<Args>(args)...); }, alternatives);
+    }
+
+private:
+    std::variant<Fs...> alternatives;
+};
+
+
+/// Non-owning reference: object pointer + trampoline, the callable has to outlive it
+template <typename Signature>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)> {
+public:
+    template <typename F>
+    function_ref(F& f) noexcept requires (!std::is_same_v<std::remove_cv_t<F>, function_ref>)
+    : object{ std::addressof(f) }
+    , call{ [](void* obj, Args... args) -> R { return (*static_cast<F*>(obj))(std::forward<Args>(args)...); } }
+    {}
+
+    R operator() (Args... args) const { return call(object, std::forward<Args>(args)...); }
+
+private:
+    void* object;
+    R (*call)(void*, Args...);
+};
+
+} // namespace vx::bench::baseline
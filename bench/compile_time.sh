@@ -0,0 +1,79 @@
+#!/usr/bin/env bash
+# Compile-time cost of vx::func: generates a translation unit using N signatures x M closure types
+# (construct, move, copy and invoke each pair) and reports compile time and object size, once with implicit
+# instantiation everywhere ("header") and once with VX_FUNC_EXTERN_TEMPLATE declarations for the signatures,
+# whose func_base is compiled once in a separate TU ("extern", instantiation TU reported on its own row).
+#
+# Usage: bench/compile_time.sh ["N1xM1 N2xM2 ..."]   (CXX and CXXFLAGS are honoured, default -O2)
+# Output: CSV mode,signatures,closures,compile_s,text_bytes
+
+set -eu
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+cxx="${CXX:-g++}"
+flags="${CXXFLAGS:--O2}"
+grid="${1:-1x1 4x4 8x8 16x16 32x8}"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+generate_common() { # signatures, extern?
+    echo '#include "func.hpp"'
+    echo '#include <cstdint>'
+    echo 'template <int I> struct arg { std::uint64_t v; };'
+    if [ "$2" = extern ]; then
+        for ((i = 0; i < $1; ++i)); do
+            echo "VX_FUNC_EXTERN_TEMPLATE(vx::cfg::function{}, std::uint64_t, arg<$i>);"
+        done
+    fi
+}
+
+generate_user() { # signatures, closures
+    echo '#include "common.hpp"'
+    echo 'template <int C> struct closure {'
+    echo '    std::uint64_t k;'
+    echo '    template <int I> std::uint64_t operator()(arg<I> a) const { return a.v * k + C; }'
+    echo '};'
+    for ((i = 0; i < $1; ++i)); do
+        for ((c = 0; c < $2; ++c)); do
+            echo "std::uint64_t use_${i}_${c}(std::uint64_t x) {"
+            echo "    vx::func<std::uint64_t(arg<$i>)> f = closure<$c>{x};"
+            echo "    auto g = std::move(f);"
+            echo "    auto h = g;"
+            echo "    return h(arg<$i>{x});"
+            echo "}"
+        done
+    done
+}
+
+generate_instantiations() { # signatures
+    echo '#include "common.hpp"'
+    for ((i = 0; i < $1; ++i)); do
+        echo "VX_FUNC_INSTANTIATE(vx::cfg::function{}, std::uint64_t, arg<$i>);"
+    done
+}
+
+compile() { # source -> prints "seconds text_bytes"
+    local start end
+    start=$(date +%s%N)
+    "$cxx" -std=c++20 $flags -I"$root" -I"$work" -c "$1" -o "$1.o"
+    end=$(date +%s%N)
+    printf '%s %s\n' "$(awk -v ns=$((end - start)) 'BEGIN { printf "%.3f", ns / 1e9 }')" \
+        "$(size -A "$1.o" | awk '$1 ~ /^\.text/ { sum += $2 } END { print sum + 0 }')"
+}
+
+echo "mode,signatures,closures,compile_s,text_bytes"
+for cell in $grid; do
+    n="${cell%x*}"
+    m="${cell#*x}"
+    for mode in header extern; do
+        generate_common "$n" "$mode" > "$work/common.hpp"
+        generate_user "$n" "$m" > "$work/user.cpp"
+        read -r seconds bytes < <(compile "$work/user.cpp")
+        echo "$mode,$n,$m,$seconds,$bytes"
+        if [ "$mode" = extern ]; then
+            generate_instantiations "$n" > "$work/instantiations.cpp"
+            read -r seconds bytes < <(compile "$work/instantiations.cpp")
+            echo "extern_instantiation_tu,$n,0,$seconds,$bytes"
+        fi
+    done
+done
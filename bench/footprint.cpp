@@ -0,0 +1,182 @@
+/// Memory footprint benchmark: millions of callbacks of a realistic size mix stored in std::vector<vx::func>.
+/// Reports bytes per callback (object + heap), RSS growth, heap allocations and iterate/invoke throughput
+/// for the usual presets and for an SBO sweep, as CSV.
+///
+///   g++ -std=c++20 -O2 footprint.cpp -o footprint && ./footprint 10000000 > footprint.csv
+///
+/// The callback count defaults to 1M. Size mix: 40% function pointers, 25% 8-byte, 15% 16-byte,
+/// 12% 32-byte, 6% 64-byte and 2% 128-byte closures. RSS is read from /proc/self/statm (Linux, 0 elsewhere).
+/// The named presets come in pairs differing in one knob: inplace/heap_enabled (allow_heap at SBO 128) and
+/// move_only_func/copyable (copyable, with vx::move_only_func's SBO 48 and can_be_empty).
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include "../func.hpp"
+#if defined __GLIBC__
+    #include <malloc.h> // malloc_trim
+#endif
+
+/// Counting global allocator
+namespace {
+std::atomic<std::size_t> heap_allocations { 0 };
+std::atomic<std::size_t> heap_bytes { 0 };
+}
+
+void* operator new(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+template <std::size_t Bytes>
+struct closure {
+    explicit closure(std::uint64_t seed) { state.fill(seed); }
+
+    std::uint64_t operator()(std::uint64_t x) noexcept {
+        state.front() += x;
+        return state.front() ^ state.back();
+    }
+
+    std::array<std::uint64_t, Bytes / 8> state;
+};
+
+using signature = std::uint64_t(std::uint64_t);
+
+/// Not noexcept: &plain is then exactly R(*)(Args...) and takes the function pointer path
+std::uint64_t plain(std::uint64_t x) { return x * 3 + 1; }
+
+template <std::size_t SBO, bool allow_heap = true, bool copyable = true, bool can_be_empty = false>
+inline constexpr vx::cfg::function preset = {
+    .SBO = SBO,
+    .can_be_empty = can_be_empty,
+    .allow_heap = allow_heap,
+    .copyable = copyable
+};
+
+std::size_t resident_bytes() {
+    std::ifstream statm {"/proc/self/statm"};
+    std::size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void release_free_memory() {
+#if defined __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+/// Deterministic size classes, the same sequence for every preset
+std::vector<std::uint8_t> make_mix(std::size_t count) {
+    constexpr std::array<int, 6> percent = { 40, 25, 15, 12, 6, 2 };
+    std::mt19937 rng {7};
+    std::uniform_int_distribution<int> dice {0, 99};
+    std::vector<std::uint8_t> mix (count);
+    for (auto& kind : mix) {
+        int roll = dice(rng);
+        std::uint8_t k = 0;
+        while (roll >= percent[k]) { roll -= percent[k++]; }
+        kind = k;
+    }
+    return mix;
+}
+
+template <typename Func>
+void emplace(std::vector<Func>& fs, std::uint8_t kind, std::uint64_t seed) {
+    switch (kind) {
+        case 0: fs.emplace_back(&plain); break;
+        case 1: fs.emplace_back(closure<8>{seed}); break;
+        case 2: fs.emplace_back(closure<16>{seed}); break;
+        case 3: fs.emplace_back(closure<32>{seed}); break;
+        case 4: fs.emplace_back(closure<64>{seed}); break;
+        default: fs.emplace_back(closure<128>{seed}); break;
+    }
+}
+
+template <typename Body>
+double elapsed_ns(Body&& body) {
+    const auto t0 = std::chrono::steady_clock::now();
+    body();
+    const auto t1 = std::chrono::steady_clock::now();
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+}
+
+std::uint64_t sink = 0;
+
+template <vx::cfg::function cfg>
+void row(const char * name, std::vector<std::uint8_t> const& mix) {
+    using Func = vx::func<signature, cfg>;
+
+    release_free_memory();
+    const auto rss_before = resident_bytes();
+    const auto allocations_before = heap_allocations.load();
+    const auto bytes_before = heap_bytes.load();
+
+    std::vector<Func> fs;
+    fs.reserve(mix.size());
+    const auto vector_allocations = heap_allocations.load() - allocations_before;
+    const auto vector_bytes = heap_bytes.load() - bytes_before;
+    for (std::size_t i = 0; i < mix.size(); ++i) { emplace(fs, mix[i], i); }
+
+    const auto allocations = heap_allocations.load() - allocations_before - vector_allocations; ///< without the vector itself
+    const auto callable_bytes = heap_bytes.load() - bytes_before - vector_bytes;
+    const auto rss_after = resident_bytes();
+    const auto rss = rss_after > rss_before ? rss_after - rss_before : 0; ///< RSS can shrink in between
+
+    std::uint64_t acc = 0;
+    const double iterate = elapsed_ns([&]{
+        for (auto& f : fs) { acc += static_cast<bool>(f); }
+    });
+    const double invoke = elapsed_ns([&]{
+        for (auto& f : fs) { acc += f(acc); }
+    });
+    sink += acc;
+
+    const double n = double(mix.size());
+    std::printf("%s,%zu,%s,%zu,%zu,%.2f,%.2f,%zu,%.4f,%.3f,%.3f\n",
+        name, cfg.SBO, cfg.allow_heap ? "yes" : "no", mix.size(), sizeof(Func),
+        (double(vector_bytes) + double(callable_bytes)) / n, double(rss) / (1024.0 * 1024.0),
+        allocations, double(allocations) / n, iterate / n, invoke / n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const auto mix = make_mix(count);
+
+    std::printf("preset,sbo,heap,callbacks,sizeof_func,bytes_per_callback,rss_mib,heap_allocs,allocs_per_callback,iterate_ns,invoke_ns\n");
+
+    /// Pairs differing only in the knob of their name
+    row<preset<128, false>>("inplace", mix);
+    row<preset<128, true>>("heap_enabled", mix);
+    row<preset<48, true, false, true>>("move_only_func", mix); ///< vx::move_only_func's configuration
+    row<preset<48, true, true, true>>("copyable", mix);
+
+    row<preset<8>>("sbo_sweep", mix);
+    row<preset<16>>("sbo_sweep", mix);
+    row<preset<24>>("sbo_sweep", mix);
+    row<preset<32>>("sbo_sweep", mix);
+    row<preset<48>>("sbo_sweep", mix);
+    row<preset<64>>("sbo_sweep", mix);
+    row<preset<96>>("sbo_sweep", mix);
+    row<preset<128>>("sbo_sweep", mix);
+
+    std::fprintf(stderr, "(checksum %llu)\n", static_cast<unsigned long long>(sink));
+}
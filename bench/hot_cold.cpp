@@ -0,0 +1,101 @@
+/// Hot/cold layout benchmark: thousands of distinct closure types invoked round-robin.
+/// Every type instantiates its own invoker and management actions; with the hot/cold annotations
+/// the invokers are grouped in .text.hot and the actions in .text.unlikely.
+///
+///   g++ -std=c++20 -O2 hot_cold.cpp -o hot_cold && ./hot_cold
+///   g++ -std=c++20 -O2 -DVX_FUNC_NO_HOT_COLD hot_cold.cpp -o interleaved && ./interleaved   ///< baseline
+///
+/// Reports ns/call plus L1i and iTLB misses per call (perf_event, Linux only; "n/a" if unavailable).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../func.hpp"
+#include "perf_counters.hpp"
+
+#ifndef VX_BENCH_TYPES
+    #define VX_BENCH_TYPES 2048
+#endif
+
+template <std::size_t I>
+struct closure {
+    std::uint64_t state = I;
+    std::uint64_t operator()(std::uint64_t x) noexcept { 
+        state += x * (I | 1);
+        return state ^ (I << 7);
+    }
+};
+
+using callback = vx::func<std::uint64_t(std::uint64_t)>;
+
+template <std::size_t... Is>
+void fill(std::vector<callback>& fs, std::index_sequence<Is...>) {
+    (fs.emplace_back(closure<Is>{}), ...);
+}
+
+void print_per_call(const char * name, vx::bench::perf_counter const& c, double calls) {
+    if (auto v = c.read()) {
+        std::printf("  %-16s %.4f\n", name, double(*v) / calls);
+    } else {
+        std::printf("  %-16s n/a\n", name);
+    }
+}
+
+int main() {
+    constexpr std::size_t types = VX_BENCH_TYPES;
+    constexpr std::size_t rounds = 200;
+
+    std::vector<callback> fs;
+    fs.reserve(types);
+    fill(fs, std::make_index_sequence<types>{});
+
+    /// Shuffle the storage order so consecutive calls don't walk the code linearly
+    std::vector<std::size_t> order (types);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937{42});
+
+    /// Some moves in between, as a real queue would do (exercises the cold actions once per round)
+    auto churn = [&]{ 
+        for (std::size_t i = 0; i + 1 < fs.size(); i += 64) { fs[i].swap(fs[i + 1]); } 
+    };
+
+    vx::bench::perf_counter l1i {vx::bench::event::l1i_misses};
+    vx::bench::perf_counter itlb {vx::bench::event::itlb_misses};
+    vx::bench::perf_counter instructions {vx::bench::event::instructions};
+
+    std::uint64_t acc = 0;
+    for (auto i : order) { acc += fs[i](1); } ///< warm-up
+
+    l1i.start(); 
+    itlb.start(); 
+    instructions.start();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        for (auto i : order) { acc += fs[i](r); }
+        churn();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    instructions.stop();
+    itlb.stop();
+    l1i.stop();
+
+    const double calls = double(types * rounds);
+    const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+#if defined VX_FUNC_NO_HOT_COLD
+    std::printf("layout: interleaved (VX_FUNC_NO_HOT_COLD)\n");
+#else 
+    std::printf("layout: hot/cold\n");
+#endif
+    std::printf("%zu closure types x %zu rounds\n", types, rounds);
+    std::printf("  %-16s %.3f\n", "ns/call", ns / calls);
+    print_per_call("l1i-misses/call", l1i, calls);
+    print_per_call("itlb-misses/call", itlb, calls);
+    print_per_call("instr/call", instructions, calls);
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(acc));
+}
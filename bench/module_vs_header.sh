@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+# Build-time comparison of consuming vx::func through `#include "func.hpp"` versus `import vx.func;`.
+# Builds the module interface (func.cppm) once, then compiles the same consumer TU K times each way
+# and reports the total and per-TU compile times. The module build time is reported on its own row.
+#
+# Usage: bench/module_vs_header.sh [K]      (CXX and CXXFLAGS are honoured)
+# Output: CSV mode,translation_units,total_s,per_tu_s; a step that does not compile is reported as a `failed` row
+# (with the first compiler errors on stderr) and ends the script with status 1.
+#
+# Needs a compiler that re-exports the using-declarations of func.cppm to importers. GCC 12 builds the module
+# interface but its importers do not see the names ("'func' is not a member of 'vx'"); Clang 16+ and GCC 14+
+# are expected to work but have not been verified with this script.
+
+set -eu
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+cxx="${CXX:-g++}"
+flags="${CXXFLAGS:--O2}"
+units="${1:-20}"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+cd "$work"
+
+if "$cxx" --version | grep -qi clang; then
+    build_module=("$cxx" -std=c++20 $flags -I"$root" --precompile "$root/func.cppm" -o vx.func.pcm)
+    module_flags=(-fmodule-file=vx.func=vx.func.pcm)
+else
+    build_module=("$cxx" -std=c++20 $flags -fmodules-ts -I"$root" -x c++ -c "$root/func.cppm" -o func.cppm.o)
+    module_flags=(-fmodules-ts)
+fi
+
+consumer() { # "include" | "import"
+    if [ "$1" = import ]; then echo 'import vx.func;'; else echo '#include "func.hpp"'; fi
+    cat <<'EOF'
+struct Big { char pad[64]; int operator()(int x) const { return x + pad[0]; } };
+int twice(int x) { return 2 * x; }
+int use(int x) {
+    vx::func<int(int)> f = [x](int y) { return x + y; };
+    auto g = f;
+    vx::move_only_func<int(int)> h = Big{};
+    vx::func<int(int)> n = vx::nontype<&twice>;
+    return f(x) + g(x) + h(x) + n(x);
+}
+EOF
+}
+
+seconds_since() { awk -v ns=$(( $(date +%s%N) - $1 )) 'BEGIN { printf "%.3f", ns / 1e9 }'; }
+
+consumer include > header_user.cpp
+consumer import > module_user.cpp
+
+echo "mode,translation_units,total_s,per_tu_s"
+
+failed() { # mode, translation units, what failed
+    echo "$1,$2,failed,"
+    echo "$3 failed ($cxx lacks the needed C++20 module support?):" >&2
+    head -5 errors.txt >&2
+    exit 1
+}
+
+compile_consumer() { # mode, index
+    if [ "$1" = header ]; then
+        "$cxx" -std=c++20 $flags -I"$root" -c header_user.cpp -o "header_$2.o" 2> errors.txt
+    else
+        "$cxx" -std=c++20 $flags "${module_flags[@]}" -c module_user.cpp -o "module_$2.o" 2> errors.txt
+    fi
+}
+
+start=$(date +%s%N)
+"${build_module[@]}" 2> errors.txt || failed module_interface 1 "module build"
+echo "module_interface,1,$(seconds_since "$start"),"
+
+for mode in header module; do
+    start=$(date +%s%N)
+    for ((i = 0; i < units; ++i)); do
+        compile_consumer "$mode" "$i" || failed "$mode" "$units" "$mode consumer build"
+    done
+    total=$(seconds_since "$start")
+    echo "$mode,$units,$total,$(awk -v t="$total" -v n="$units" 'BEGIN { printf "%.3f", t / n }')"
+done
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint> // std::uint64_t
+#include <optional>
+
+#if defined __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace vx::bench {
+
+/// Hardware events the benchmarks care about
+enum class event { cycles, instructions, branch_misses, l1i_misses, itlb_misses };
+
+/// One perf_event counter for the calling thread (user space only).
+/// Unavailable (no Linux, no PMU in the VM, perf_event_paranoid too strict) => read() returns nullopt
+class perf_counter {
+public:
+    explicit perf_counter(event e) noexcept {
+#if defined __linux__
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        switch (e) {
+            case event::cycles: 
+                attr.type = PERF_TYPE_HARDWARE; 
+                attr.config = PERF_COUNT_HW_CPU_CYCLES; 
+                break;
+            case event::instructions: 
+                attr.type = PERF_TYPE_HARDWARE; 
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS; 
+                break;
+            case event::branch_misses: 
+                attr.type = PERF_TYPE_HARDWARE; 
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES; 
+                break;
+            case event::l1i_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1I | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case event::itlb_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_ITLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+        }
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else 
+        (void)e;
+#endif
+    }
+
+    perf_counter(perf_counter const&) = delete;
+    perf_counter& operator= (perf_counter const&) = delete;
+
+    ~perf_counter() {
+#if defined __linux__
+        if (fd >= 0) { close(fd); }
+#endif
+    }
+
+    bool available() const noexcept { return fd >= 0; }
+
+    void start() noexcept {
+#if defined __linux__
+        if (fd < 0) { return; }
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    void stop() noexcept {
+#if defined __linux__
+        if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+#endif
+    }
+
+    std::optional<std::uint64_t> read() const noexcept {
+#if defined __linux__
+        std::uint64_t value = 0;
+        if (fd >= 0 && ::read(fd, &value, sizeof(value)) == sizeof(value)) { return value; }
+#endif
+        return std::nullopt;
+    }
+
+private:
+    int fd = -1;
+};
+
+} // namespace vx::bench
@@ -0,0 +1,185 @@
+/// Trace replay benchmark: reconstructs the heterogeneous mix of vx::func objects seen by a real application
+/// and replays its call sequence, so indirect branch prediction behaves as it did in production.
+///
+/// Recording: build the application with -DVX_FUNC_TRACE and call vx::trace::save("app.trace") at the end.
+///
+///   g++ -std=c++20 -O2 replay.cpp -o replay
+///   ./replay app.trace      ///< replays a recorded trace
+///   ./replay                ///< replays a synthetic skewed trace (64 types, 512 objects)
+///
+/// Every recorded callable type becomes a distinct synthetic closure type of the nearest size class (8-256 bytes),
+/// every recorded object (address + type) one vx::func. The same calls are also timed grouped by object,
+/// i.e. the perfectly predicted pattern of a synthetic loop. The replay uses a fixed uint64_t(uint64_t) signature;
+/// recorded argument sizes are only reported.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../func.hpp"
+#include "../time.hpp"
+#include "perf_counters.hpp"
+
+namespace {
+
+using callback = vx::func<std::uint64_t(std::uint64_t)>;
+
+constexpr std::size_t distinct_types = 128; ///< recorded types beyond that share synthetic types
+constexpr std::array<std::size_t, 6> size_classes = { 8, 16, 32, 64, 128, 256 };
+
+template <std::size_t I, std::size_t Bytes>
+struct closure {
+    std::array<std::uint64_t, Bytes / 8> state {};
+
+    std::uint64_t operator()(std::uint64_t x) noexcept {
+        state.front() += x * (I | 1);
+        return state.front() ^ (I << 9);
+    }
+};
+
+using factory = void (*)(std::vector<callback>&);
+
+template <std::size_t I, std::size_t... Cs>
+constexpr std::array<factory, size_classes.size()> factories_for(std::index_sequence<Cs...>) {
+    return { +[](std::vector<callback>& fs) { fs.emplace_back(closure<I, size_classes[Cs]>{}); }... };
+}
+
+template <std::size_t... Is>
+constexpr auto make_factories(std::index_sequence<Is...>) {
+    return std::array<std::array<factory, size_classes.size()>, sizeof...(Is)> {
+        factories_for<Is>(std::make_index_sequence<size_classes.size()>{})...
+    };
+}
+
+constexpr auto factories = make_factories(std::make_index_sequence<distinct_types>{});
+
+struct recorded_type {
+    std::size_t size = 8;
+    std::size_t argument_bytes = 0;
+};
+
+struct trace {
+    std::vector<recorded_type> types;
+    std::vector<std::uint32_t> object_type; ///< per object
+    std::vector<std::uint32_t> calls;       ///< object index per call
+};
+
+bool load(const char * path, trace& t) {
+    std::FILE * in = std::fopen(path, "r");
+    if (in == nullptr) { return false; }
+    int version = 0;
+    std::size_t type_total = 0, event_total = 0;
+    bool ok = std::fscanf(in, "vx-func-trace %d types %zu", &version, &type_total) == 2 && version == 1;
+    for (std::size_t i = 0; ok && i < type_total; ++i) {
+        std::size_t id, size, alignment, argument_bytes;
+        ok = std::fscanf(in, "%zu %zu %zu %zu %*[^\n]", &id, &size, &alignment, &argument_bytes) == 4;
+        t.types.push_back({ size, argument_bytes });
+    }
+    ok = ok && std::fscanf(in, " events %zu", &event_total) == 1;
+
+    std::map<std::pair<void*, unsigned>, std::uint32_t> objects;
+    for (std::size_t i = 0; ok && i < event_total; ++i) {
+        unsigned type = 0;
+        void * address = nullptr;
+        ok = std::fscanf(in, "%u %p", &type, &address) == 2 && type < t.types.size();
+        if (!ok) { break; }
+        auto [it, inserted] = objects.try_emplace({address, type}, static_cast<std::uint32_t>(t.object_type.size()));
+        if (inserted) { t.object_type.push_back(type); }
+        t.calls.push_back(it->second);
+    }
+    std::fclose(in);
+    return ok;
+}
+
+/// Skewed synthetic trace: Zipf-like type popularity, bursts of calls to the same object
+trace synthetic() {
+    trace t;
+    std::mt19937 rng {2024};
+    for (std::size_t i = 0; i < 64; ++i) { t.types.push_back({ size_classes[rng() % size_classes.size()], 8 }); }
+    for (std::size_t i = 0; i < 512; ++i) {
+        t.object_type.push_back(static_cast<std::uint32_t>(std::min<std::size_t>(64 - 1, std::size_t(std::exponential_distribution<>{0.1}(rng)))));
+    }
+    std::geometric_distribution<> burst {0.5};
+    while (t.calls.size() < 1'000'000) {
+        const auto object = static_cast<std::uint32_t>(std::min<std::size_t>(511, std::size_t(std::exponential_distribution<>{0.02}(rng))));
+        for (int n = burst(rng) + 1; n > 0; --n) { t.calls.push_back(object); }
+    }
+    return t;
+}
+
+std::size_t size_class(std::size_t size) {
+    for (std::size_t c = 0; c < size_classes.size(); ++c) {
+        if (size <= size_classes[c]) { return c; }
+    }
+    return size_classes.size() - 1;
+}
+
+void print_per_call(const char * name, vx::bench::perf_counter const& c, double calls) {
+    if (auto v = c.read()) {
+        std::printf("  %-20s %.4f\n", name, double(*v) / calls);
+    } else {
+        std::printf("  %-20s n/a\n", name);
+    }
+}
+
+std::uint64_t sink = 0;
+
+void run(const char * name, std::vector<callback>& objects, std::vector<std::uint32_t> const& calls) {
+    vx::bench::perf_counter branch_misses {vx::bench::event::branch_misses};
+    std::uint64_t acc = 0;
+    for (auto o : calls) { acc += objects[o](acc); } ///< warm-up
+
+    branch_misses.start();
+    const auto m = vx::timeit([&]{
+        for (auto o : calls) { acc += objects[o](acc); }
+    });
+    branch_misses.stop();
+    sink += acc;
+
+    const double n = double(calls.size());
+    std::printf("%s\n", name);
+    std::printf("  %-20s %.3f\n", "ns/call", m.in<vx::time::ns>() / n);
+    std::printf("  %-20s %.3f\n", "cycles/call", m.cycles_per(calls.size()));
+    print_per_call("branch-misses/call", branch_misses, n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    trace t;
+    if (argc > 1) {
+        if (!load(argv[1], t)) {
+            std::fprintf(stderr, "cannot read trace %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        t = synthetic();
+    }
+
+    std::vector<callback> objects;
+    objects.reserve(t.object_type.size());
+    for (auto type : t.object_type) {
+        factories[type % distinct_types][size_class(t.types[type].size)](objects);
+    }
+
+    std::size_t argument_bytes = 0;
+    for (auto o : t.calls) { argument_bytes += t.types[t.object_type[o]].argument_bytes; }
+
+    std::printf("%s: %zu types, %zu objects, %zu calls, %.1f argument bytes/call (recorded)\n",
+        argc > 1 ? argv[1] : "synthetic trace", t.types.size(), objects.size(), t.calls.size(),
+        t.calls.empty() ? 0.0 : double(argument_bytes) / double(t.calls.size()));
+    if (t.calls.empty()) { return 0; }
+
+    run("replay (recorded order)", objects, t.calls);
+
+    auto grouped = t.calls;
+    std::sort(grouped.begin(), grouped.end());
+    run("grouped by object (synthetic loop)", objects, grouped);
+
+    std::fprintf(stderr, "(checksum %llu)\n", static_cast<unsigned long long>(sink));
+}
@@ -0,0 +1,172 @@
+/// Task graph benchmark: construction and execution of wide, deep and random DAGs with vx::task_graph
+/// (flat arrays of vx::move_only_func<void()>) against the usual std::function + shared_ptr node graph.
+///
+///   g++ -std=c++20 -O2 -pthread task_graph.cpp -o task_graph && ./task_graph [nodes] [threads]
+///
+/// Shapes: wide (one source, N-2 independent tasks, one sink), deep (a chain of N tasks) and random
+/// (every node depends on up to 3 earlier nodes). Every task does a little arithmetic on its own 32-byte closure
+/// and stores the result into its own slot. Build covers adding the tasks and edges and, for vx::task_graph,
+/// prepare() (CSR successor arrays, cycle check, per-run state) which the first run would otherwise do.
+/// The baseline is run by a sequential Kahn traversal (its best case: no synchronization at all); vx::task_graph
+/// is run by vx::task_executor with 1 and with `threads` threads (default: hardware concurrency).
+/// Output: CSV shape,nodes,edges,impl,threads,build_ns_per_node,run_ns_per_node,heap_allocations
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../task_graph.hpp"
+#include "../time.hpp"
+
+/// Counting global allocator
+namespace {
+std::atomic<std::size_t> heap_allocations { 0 };
+}
+
+void* operator new(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using edge_list = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+edge_list wide(std::uint32_t n) {
+    edge_list edges;
+    for (std::uint32_t i = 1; i + 1 < n; ++i) {
+        edges.push_back({ 0, i });
+        edges.push_back({ i, n - 1 });
+    }
+    return edges;
+}
+
+edge_list deep(std::uint32_t n) {
+    edge_list edges;
+    for (std::uint32_t i = 1; i < n; ++i) { edges.push_back({ i - 1, i }); }
+    return edges;
+}
+
+edge_list random_dag(std::uint32_t n) {
+    std::mt19937 rng { 42 };
+    edge_list edges;
+    for (std::uint32_t i = 1; i < n; ++i) {
+        const auto fan_in = std::min<std::uint32_t>(i, 1 + rng() % 3);
+        for (std::uint32_t k = 0; k < fan_in; ++k) { edges.push_back({ static_cast<std::uint32_t>(rng() % i), i }); }
+    }
+    return edges;
+}
+
+/// 32-byte task closure
+struct work {
+    std::uint64_t * sink;
+    std::uint64_t seed, a, b;
+
+    void operator()() {
+        auto x = seed;
+        for (int i = 0; i < 16; ++i) { x = x * a + b; }
+        *sink = x & 1;
+    }
+};
+
+/// Baseline: heap nodes holding std::function and shared_ptr successor lists
+struct shared_node {
+    std::function<void()> task;
+    std::vector<std::shared_ptr<shared_node>> successors;
+    std::uint32_t predecessors = 0;
+    std::uint32_t pending = 0;
+};
+
+void report(char const* shape, std::uint32_t n, std::size_t edges, char const* impl, std::size_t threads,
+            double build_cycles, double run_cycles, std::size_t allocations) {
+    const double ns_per_cycle = 1.0 / vx::time::counter::ticks_per_ns();
+    std::printf("%s,%u,%zu,%s,%zu,%.1f,%.1f,%zu\n", shape, n, edges, impl, threads,
+        build_cycles * ns_per_cycle / n, run_cycles * ns_per_cycle / n, allocations);
+}
+
+void bench_shape(char const* shape, std::uint32_t n, edge_list const& edges, std::size_t threads) {
+    std::vector<std::uint64_t> sinks(n); ///< one slot per task: no two tasks write the same location
+
+    /// vx::task_graph
+    for (std::size_t t : { std::size_t{1}, threads }) {
+        vx::task_executor pool { t };
+        vx::task_graph graph;
+        const auto allocations_before = heap_allocations.load();
+        const auto build = vx::timeit([&] {
+            graph.reserve(n, edges.size());
+            for (std::uint32_t i = 0; i < n; ++i) { graph.add(work{ &sinks[i], i, 6364136223846793005ull, 1442695040888963407ull }); }
+            for (auto [before, after] : edges) { graph.precede(before, after); }
+            graph.prepare();
+        });
+        const auto allocations = heap_allocations.load() - allocations_before;
+        pool.run(graph); ///< warm-up
+        const auto run = vx::timeit(5, [&] { pool.run(graph); });
+        report(shape, n, edges.size(), "vx_task_graph", t, build.cycles(), run.cycles(), allocations);
+        if (t == threads) { break; }
+    }
+
+    /// std::function + shared_ptr nodes, sequential
+    {
+        std::vector<std::shared_ptr<shared_node>> nodes;
+        const auto allocations_before = heap_allocations.load();
+        const auto build = vx::timeit([&] {
+            nodes.reserve(n);
+            for (std::uint32_t i = 0; i < n; ++i) {
+                auto node = std::make_shared<shared_node>();
+                node->task = work{ &sinks[i], i, 6364136223846793005ull, 1442695040888963407ull };
+                nodes.push_back(std::move(node));
+            }
+            for (auto [before, after] : edges) {
+                nodes[before]->successors.push_back(nodes[after]);
+                ++nodes[after]->predecessors;
+            }
+        });
+        const auto allocations = heap_allocations.load() - allocations_before;
+        std::vector<shared_node*> ready;
+        ready.reserve(n);
+        const auto run = vx::timeit(5, [&] {
+            ready.clear();
+            for (auto& node : nodes) {
+                node->pending = node->predecessors;
+                if (node->pending == 0) { ready.push_back(node.get()); }
+            }
+            while (!ready.empty()) {
+                auto * node = ready.back();
+                ready.pop_back();
+                node->task();
+                for (auto& next : node->successors) {
+                    if (--next->pending == 0) { ready.push_back(next.get()); }
+                }
+            }
+        });
+        report(shape, n, edges.size(), "std_function_shared_ptr", 1, build.cycles(), run.cycles(), allocations);
+    }
+
+    std::uint64_t total = 0;
+    for (auto s : sinks) { total += s; }
+    if (total == 42) { std::puts(""); } ///< keep the work observable
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto n = static_cast<std::uint32_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100'000);
+    const std::size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("shape,nodes,edges,impl,threads,build_ns_per_node,run_ns_per_node,heap_allocations\n");
+    bench_shape("wide", n, wide(n), threads);
+    bench_shape("deep", n, deep(n), threads);
+    bench_shape("random", n, random_dag(n), threads);
+}
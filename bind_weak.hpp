@@ -0,0 +1,169 @@
+#pragma once
+
+/// Callbacks bound weakly to objects that may die first (widgets, connections) without weak_ptr:
+///
+///     struct button : vx::weakly_referenced<button> { void clicked(int x); };
+///
+///     auto b = std::make_unique<button>();
+///     vx::func<void(int)> on_click = vx::bind_weak(b->weak_ref(), &button::clicked); ///< 24 bytes, stays in the SBO
+///     vx::func<void(int)> compact = vx::bind_weak<&button::clicked>(b->weak_ref());  ///< 8 bytes
+///     on_click(1); ///< calls b->clicked(1)
+///     b.reset();
+///     on_click(2); ///< no-op
+///
+/// Every weakly_referenced object owns a slot of a global table holding its address and a generation, which is
+/// bumped when the object dies. A weak_handle is (slot index, generation): liveness is one plain load and compare,
+/// no reference counting and no atomics. Calls of methods returning non-void yield std::optional (empty if dead).
+///
+/// Slots are taken and released under a mutex, but the liveness check is not synchronized: an object must not be
+/// destroyed concurrently with calls through its handles (the usual single-threaded UI / event loop setting).
+
+#include <cstdint> // std::uint32_t
+#include <functional> // std::invoke
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "func.hpp"
+
+namespace vx {
+
+namespace detail::weak {
+
+struct slot {
+    void * object;
+    std::uint32_t generation; ///< 1 on first use, bumped on release (unused slots hold a null object)
+    std::uint32_t next_free;
+};
+
+inline constexpr std::uint32_t chunk_bits = 12;
+inline constexpr std::uint32_t chunk_size = std::uint32_t{1} << chunk_bits;
+inline constexpr std::uint32_t max_chunks = 1024; ///< 4M live objects
+inline constexpr std::uint32_t no_slot = ~std::uint32_t{0};
+
+inline slot first_chunk [chunk_size] {};
+inline slot * chunks [max_chunks] { first_chunk };
+inline std::uint32_t slot_count = 0;
+inline std::uint32_t free_head = no_slot;
+inline std::mutex table_mutex;
+
+[[nodiscard]] inline slot & at(std::uint32_t index) noexcept {
+    return chunks[index >> chunk_bits][index & (chunk_size - 1)];
+}
+
+inline std::uint32_t acquire(void * object) {
+    std::lock_guard lock{ table_mutex };
+    std::uint32_t index = free_head;
+    if (index != no_slot) {
+        free_head = at(index).next_free;
+    } else {
+        if (slot_count == chunk_size * max_chunks) { throw bad_function_operation{"too many weakly referenced objects"}; }
+        index = slot_count;
+        if (chunks[index >> chunk_bits] == nullptr) { chunks[index >> chunk_bits] = new slot [chunk_size] {}; } ///< never freed
+        ++slot_count;
+        at(index).generation = 1;
+    }
+    at(index).object = object;
+    return index;
+}
+
+inline void release(std::uint32_t index) noexcept {
+    std::lock_guard lock{ table_mutex };
+    auto& s = at(index);
+    s.object = nullptr;
+    s.generation = s.generation + 1 == 0 ? 1 : s.generation + 1;
+    s.next_free = free_head;
+    free_head = index;
+}
+
+} // namespace detail::weak
+
+
+template <typename C>
+class weakly_referenced;
+
+/// @brief Non-owning (slot index, generation) reference to a weakly_referenced C
+template <typename C>
+class weak_handle {
+public:
+    weak_handle() noexcept = default;
+
+    /// The object if it is still alive, nullptr otherwise
+    [[nodiscard]] C * get() const noexcept {
+        auto const& s = detail::weak::at(index);
+        return s.generation == generation ? static_cast<C*>(static_cast<weakly_referenced<C>*>(s.object)) : nullptr;
+    }
+
+    [[nodiscard]] bool expired() const noexcept { return get() == nullptr; }
+
+    friend bool operator== (weak_handle, weak_handle) = default;
+
+private:
+    friend class weakly_referenced<C>;
+
+    weak_handle(std::uint32_t index, std::uint32_t generation) noexcept : index{ index }, generation{ generation } {}
+
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+};
+
+/// @brief CRTP base giving C a table slot for its lifetime; copies get their own slot, handles don't follow moves
+template <typename C>
+class weakly_referenced {
+public:
+    [[nodiscard]] vx::weak_handle<C> weak_ref() const noexcept {
+        return { index, detail::weak::at(index).generation };
+    }
+
+protected:
+    weakly_referenced() : index{ detail::weak::acquire(this) } {}
+    weakly_referenced(weakly_referenced const&) : weakly_referenced() {}
+    weakly_referenced& operator= (weakly_referenced const&) noexcept { return *this; }
+    ~weakly_referenced() { detail::weak::release(index); }
+
+private:
+    std::uint32_t index;
+};
+
+
+namespace detail {
+
+/// Weak handle plus method (a member pointer, or an empty nontype_t<&C::method>)
+template <typename C, typename Method>
+struct weak_bound {
+    vx::weak_handle<C> handle;
+#ifdef _MSC_VER
+    [[msvc::no_unique_address]] Method method;
+#else
+    [[no_unique_address]] Method method;
+#endif
+
+    template <typename... Args> requires std::invocable<Method const&, C&, Args...>
+    auto operator() (Args&&... args) const {
+        using result = std::invoke_result_t<Method const&, C&, Args...>;
+        C * object = handle.get();
+        if constexpr (std::is_void_v<result>) {
+            if (object != nullptr) { std::invoke(method, *object, std::forward<Args>(args)...); }
+        } else {
+            return object != nullptr
+                ? std::optional<std::remove_cvref_t<result>>{ std::invoke(method, *object, std::forward<Args>(args)...) }
+                : std::nullopt;
+        }
+    }
+};
+
+} // namespace detail
+
+/// @brief Callable invoking method on the object of handle while it is alive (nothing, or std::nullopt, afterwards)
+template <typename C, typename M>
+[[nodiscard]] auto bind_weak(weak_handle<C> handle, M C::* method) noexcept {
+    return detail::weak_bound<C, M C::*>{ handle, method };
+}
+
+/// @brief Same with the method baked into the callable: only the 8-byte handle is stored
+template <auto method, typename C>
+[[nodiscard]] auto bind_weak(weak_handle<C> handle) noexcept {
+    return detail::weak_bound<C, nontype_t<method>>{ handle, nontype<method> };
+}
+
+} // namespace vx
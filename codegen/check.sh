@@ -0,0 +1,89 @@
+#!/usr/bin/env bash
+# Codegen regression checks for the invocation hot path.
+#
+# Compiles reference.cpp, disassembles the reference functions with objdump and asserts on
+# instruction counts, indirect branches, calls to operator new and exception landing pads.
+# Thresholds are tuned for -O2 on x86-64 (GCC 12+, Clang 15+); AArch64 branch mnemonics are recognized too.
+#
+# Usage: codegen/check.sh            (CXX, CXXFLAGS and OBJDUMP are honoured)
+# Exit status is the number of failed checks.
+
+set -u
+
+here="$(cd "$(dirname "$0")" && pwd)"
+cxx="${CXX:-g++}"
+objdump="${OBJDUMP:-objdump}"
+flags="${CXXFLAGS:--O2}"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+"$cxx" -std=c++20 $flags -c "$here/reference.cpp" -o "$work/reference.o" || exit 100
+"$objdump" -dr --no-show-raw-insn "$work/reference.o" > "$work/reference.s" || exit 100
+
+failures=0
+
+# Disassembly of a function, including its split-off cold part (name.cold)
+body() {
+    awk -v hot="<$1>:" -v cold="<$1.cold>:" '
+        index($0, hot) || index($0, cold) { inside = 1; next }
+        inside && /^$/ { inside = 0 }
+        inside' "$work/reference.s"
+}
+
+# Hot part only
+hot_body() {
+    awk -v hot="<$1>:" '
+        index($0, hot) { inside = 1; next }
+        inside && /^$/ { inside = 0 }
+        inside' "$work/reference.s"
+}
+
+# Instructions without relocation records and alignment padding
+instructions() {
+    grep -vE 'R_[A-Z0-9_]+' | grep -E '^ *[0-9a-f]+:' | grep -vE '\s(nop[lw]?|xchg +%ax,%ax|data16|cs nopw)\b'
+}
+
+count() { grep -cE "$1" || true; }
+
+expect() { # name, description, actual, operator, limit
+    if [ "$3" "$4" "$5" ]; then
+        printf 'ok    %-20s %s (%s)\n' "$1" "$2" "$3"
+    else
+        printf 'FAIL  %-20s %s: %s, expected %s %s\n' "$1" "$2" "$3" "$4" "$5"
+        failures=$((failures + 1))
+    fi
+}
+
+indirect='(jmp|call)q? +\*|\s(br|blr) +x'
+allocation='_Znw|_Zna|operator new|malloc'
+landing_pad='_Unwind_Resume|__cxa_begin_catch|__cxa_end_catch|terminate'
+
+check() { # name, max hot instructions, max indirect branches
+    local name="$1"
+    if ! grep -q "<$name>:" "$work/reference.s"; then
+        printf 'FAIL  %-20s missing from the object file\n' "$name"
+        failures=$((failures + 1))
+        return
+    fi
+    expect "$name" "hot instructions" "$(hot_body "$name" | instructions | wc -l)" -le "$2"
+    expect "$name" "indirect branches" "$(hot_body "$name" | instructions | count "$indirect")" -le "$3"
+    expect "$name" "operator new calls" "$(body "$name" | count "$allocation")" -eq 0
+    expect "$name" "landing pads" "$(body "$name" | count "$landing_pad")" -eq 0
+}
+
+for preset in plain move_only inplace can_be_empty nothrow checked; do
+    check "${preset}_invoke" 10 2   # fptr fast path: two tail jumps
+    check "${preset}_move" 28 1     # one Move action, no allocation
+    check "${preset}_destroy" 14 1  # one Dtor action
+done
+
+check no_fptr_invoke 2 1            # a single `jmp *call(%rdi)`
+check no_fptr_move 28 1
+check no_fptr_destroy 12 1
+
+# check_empty has to test for the empty state (throwing path may be split off into .cold)
+expect checked_invoke "throws bad_function_call" "$(body checked_invoke | count 'bad_function_call|__cxa_throw')" -gt 0
+expect plain_invoke "no empty check" "$(body plain_invoke | count 'bad_function_call|__cxa_throw')" -eq 0
+expect can_be_empty_invoke "no empty check" "$(body can_be_empty_invoke | count 'bad_function_call|__cxa_throw')" -eq 0
+
+exit "$failures"
@@ -0,0 +1,54 @@
+// Reference functions for the codegen checks (see check.sh): one invoke/move/destroy per preset,
+// with C linkage so the disassembly can be located by name.
+
+#include <new>
+#include <utility>
+#include "../func.hpp"
+
+namespace presets {
+
+inline constexpr vx::cfg::function plain = {};
+
+inline constexpr vx::cfg::function move_only = {
+    .copyable = false
+};
+
+inline constexpr vx::cfg::function inplace = {
+    .allow_heap = false
+};
+
+inline constexpr vx::cfg::function can_be_empty = {
+    .can_be_empty = true
+};
+
+inline constexpr vx::cfg::function no_fptr = {
+    .optimize_for_func_ptrs = false
+};
+
+inline constexpr vx::cfg::function nothrow = {
+    .require_nothrow_invocable = true
+};
+
+inline constexpr vx::cfg::function checked = {
+    .check_empty = true
+};
+
+} // namespace presets
+
+#define VX_CODEGEN_REFERENCE(name, signature, cfg)                                          \
+    using name##_func = vx::func<signature, cfg>;                                         \
+    extern "C" int name##_invoke(name##_func& f, int x) { return f(x); }                  \
+    extern "C" void name##_move(name##_func& from, void* to) {                            \
+        new (to) name##_func(std::move(from));                                            \
+    }                                                                                     \
+    extern "C" void name##_destroy(name##_func& f) { f.~name##_func(); }
+
+VX_CODEGEN_REFERENCE(plain, int(int), presets::plain)
+VX_CODEGEN_REFERENCE(move_only, int(int), presets::move_only)
+VX_CODEGEN_REFERENCE(inplace, int(int), presets::inplace)
+VX_CODEGEN_REFERENCE(can_be_empty, int(int), presets::can_be_empty)
+VX_CODEGEN_REFERENCE(no_fptr, int(int), presets::no_fptr)
+VX_CODEGEN_REFERENCE(nothrow, int(int) noexcept, presets::nothrow)
+VX_CODEGEN_REFERENCE(checked, int(int), presets::checked)
+
+#undef VX_CODEGEN_REFERENCE
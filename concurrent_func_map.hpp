@@ -0,0 +1,253 @@
+#pragma once
+
+/// Read-mostly concurrent handler registry keyed by runtime IDs:
+///
+///     vx::concurrent_func_map<std::uint32_t, void(request&)> handlers;
+///     handlers.insert_or_assign(42, [](request& r) { ... });   ///< rare, serialized among writers
+///     handlers.invoke(r.method_id, r);                          ///< any number of threads, lock-free
+///
+/// Readers never lock and never copy the func: the map is an immutable open-addressed table of funcs reached
+/// through one atomic pointer. A write copies the current table with the change applied (O(size)), publishes it
+/// and retires the old one, which is freed once no reader that could still see it is inside a lookup (epoch based
+/// reclamation; each reading thread announces the epoch in its own cache line).
+///
+/// Handlers are invoked as const (the funcs are const-invocable) and concurrently, so they have to be thread-safe.
+/// A handler may look up the same or another map (guards nest). Funcs must be copyable.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::hash
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "func.hpp"
+
+namespace vx {
+
+namespace detail::epoch {
+
+/// Announcement of one reading thread; records are never freed and are reused after their thread exits
+struct alignas(64) reader {
+    std::atomic<std::uint64_t> announced {0}; ///< 0: not inside a lookup
+    std::atomic<bool> in_use {true};
+    reader * next = nullptr;
+    std::uint32_t depth = 0; ///< nesting, owner thread only
+};
+
+inline std::atomic<std::uint64_t> global {1};
+inline std::atomic<reader*> readers {nullptr};
+
+inline reader& this_thread_reader() {
+    struct owner {
+        reader * r;
+        owner() {
+            for (r = readers.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                bool free = false;
+                if (r->in_use.compare_exchange_strong(free, true, std::memory_order_acquire)) { return; }
+            }
+            r = new reader{};
+            r->next = readers.load(std::memory_order_relaxed);
+            while (!readers.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+        ~owner() { r->in_use.store(false, std::memory_order_release); }
+    };
+    thread_local owner mine;
+    return *mine.r;
+}
+
+/// RAII read-side critical section: objects retired at epoch E are freed only after every guard
+/// announced at or before E has ended
+class guard {
+public:
+    guard() : self{ this_thread_reader() } {
+        if (self.depth++ == 0) {
+            self.announced.store(global.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            /// Orders the announcement before the reader's (acquire) loads of published pointers: without it
+            /// the load may be satisfied first and see a table the writer then frees, missing this announcement
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    ~guard() {
+        if (--self.depth == 0) { self.announced.store(0, std::memory_order_release); }
+    }
+
+    guard(guard const&) = delete;
+    guard& operator= (guard const&) = delete;
+
+private:
+    reader & self;
+};
+
+/// Closes the current epoch (call after unpublishing an object); returns the epoch to retire it under
+inline std::uint64_t advance() noexcept {
+    return global.fetch_add(1, std::memory_order_seq_cst);
+}
+
+/// Oldest epoch announced by an active reader (max if none)
+inline std::uint64_t oldest_announced() noexcept {
+    auto oldest = ~std::uint64_t{0};
+    for (auto * r = readers.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        const auto e = r->announced.load(std::memory_order_seq_cst);
+        if (e != 0 && e < oldest) { oldest = e; }
+    }
+    return oldest;
+}
+
+} // namespace detail::epoch
+
+
+template <typename Key, typename Signature, cfg::function cfg = cfg::function{}, typename Hash = std::hash<Key>>
+class concurrent_func_map;
+
+/// @brief Lock-free lookup and invocation, copy-on-write registration
+template <typename Key, typename R, typename... Args, cfg::function cfg, typename Hash>
+class concurrent_func_map<Key, R(Args...), cfg, Hash> {
+public:
+    using value_type = func<R(Args...) const, cfg>;
+
+    static_assert(cfg.copyable, "concurrent_func_map copies the funcs into each new table: cfg.copyable is required");
+
+    concurrent_func_map() = default;
+    concurrent_func_map(concurrent_func_map const&) = delete;
+    concurrent_func_map& operator= (concurrent_func_map const&) = delete;
+
+    /// Frees all tables: no thread may use the map anymore
+    ~concurrent_func_map() {
+        delete current.load(std::memory_order_relaxed);
+        for (auto& r : retired) { delete r.snapshot; }
+    }
+
+    /// Invokes the handler of key in place; throws vx::bad_function_call for unknown keys
+    R invoke(Key const& key, Args... args) const {
+        detail::epoch::guard reading;
+        auto const* handler = current.load(std::memory_order_acquire)->find(key);
+        if (handler == nullptr) { throw bad_function_call{}; }
+        return (*handler)(std::forward<Args>(args)...);
+    }
+
+    /// Invokes the handler of key if there is one: returns whether it did (void R) or the result as std::optional<R>
+    auto try_invoke(Key const& key, Args... args) const {
+        detail::epoch::guard reading;
+        auto const* handler = current.load(std::memory_order_acquire)->find(key);
+        if constexpr (std::is_void_v<R>) {
+            if (handler == nullptr) { return false; }
+            (*handler)(std::forward<Args>(args)...);
+            return true;
+        } else {
+            if (handler == nullptr) { return std::optional<R>{}; }
+            return std::optional<R>{ (*handler)(std::forward<Args>(args)...) };
+        }
+    }
+
+    [[nodiscard]] bool contains(Key const& key) const {
+        detail::epoch::guard reading;
+        return current.load(std::memory_order_acquire)->find(key) != nullptr;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        detail::epoch::guard reading;
+        return current.load(std::memory_order_acquire)->count;
+    }
+
+    /// Publishes a table with key mapped to callable; returns false if an existing handler was replaced
+    template <typename F>
+    bool insert_or_assign(Key const& key, F && callable) {
+        value_type handler { std::forward<F>(callable) };
+        std::lock_guard writing{ write_mutex };
+        auto const& old = *current.load(std::memory_order_relaxed);
+        const bool inserted = old.find(key) == nullptr;
+        auto next = std::make_unique<table>(old, old.count + inserted);
+        next->assign(key, std::move(handler));
+        publish(std::move(next));
+        return inserted;
+    }
+
+    /// Publishes a table without key; false if there was no handler
+    bool erase(Key const& key) {
+        std::lock_guard writing{ write_mutex };
+        auto const& old = *current.load(std::memory_order_relaxed);
+        if (old.find(key) == nullptr) { return false; }
+        publish(std::make_unique<table>(old, old.count - 1, &key));
+        return true;
+    }
+
+private:
+    struct entry {
+        Key key;
+        value_type handler;
+    };
+
+    /// Immutable once published: open addressing with linear probing, at most half full
+    struct table {
+        std::vector<std::optional<entry>> slots;
+        std::size_t count = 0;
+
+        table() : slots(8) {}
+
+        /// Copy of source, sized for expected entries, without skipped
+        table(table const& source, std::size_t expected, Key const* skipped = nullptr) : slots(capacity_for(expected)) {
+            for (auto const& s : source.slots) {
+                if (s && !(skipped != nullptr && s->key == *skipped)) { assign(s->key, value_type{ s->handler }); }
+            }
+        }
+
+        [[nodiscard]] value_type const* find(Key const& key) const {
+            const auto mask = slots.size() - 1;
+            for (auto i = Hash{}(key) & mask;; i = (i + 1) & mask) {
+                if (!slots[i]) { return nullptr; }
+                if (slots[i]->key == key) { return &slots[i]->handler; }
+            }
+        }
+
+        void assign(Key const& key, value_type && handler) {
+            const auto mask = slots.size() - 1;
+            for (auto i = Hash{}(key) & mask;; i = (i + 1) & mask) {
+                if (!slots[i]) {
+                    slots[i].emplace(entry{ key, std::move(handler) });
+                    ++count;
+                    return;
+                }
+                if (slots[i]->key == key) {
+                    slots[i]->handler = std::move(handler);
+                    return;
+                }
+            }
+        }
+
+        static std::size_t capacity_for(std::size_t expected) noexcept {
+            std::size_t capacity = 8;
+            while (capacity < 2 * expected) { capacity *= 2; }
+            return capacity;
+        }
+    };
+
+    struct retired_table {
+        table * snapshot;
+        std::uint64_t epoch;
+    };
+
+    /// Under write_mutex: swaps in next, retires the previous table and frees what no reader can see anymore
+    void publish(std::unique_ptr<table> next) {
+        retired.reserve(retired.size() + 1);
+        auto * previous = current.exchange(next.release(), std::memory_order_seq_cst);
+        retired.push_back({ previous, detail::epoch::advance() });
+
+        const auto oldest = detail::epoch::oldest_announced();
+        std::erase_if(retired, [oldest](retired_table const& r) {
+            if (r.epoch >= oldest) { return false; }
+            delete r.snapshot;
+            return true;
+        });
+    }
+
+    std::atomic<table*> current { new table{} };
+    std::mutex write_mutex;
+    std::vector<retired_table> retired;
+};
+
+} // namespace vx
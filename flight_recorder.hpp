@@ -0,0 +1,177 @@
+#pragma once
+
+/// Flight recorder for vx::func invocations: with cfg.trace_invocations every call of a stored callable
+/// writes {type ID, TSC start, TSC end} into a per-thread ring buffer (the last VX_FLIGHT_RECORDER_CAPACITY
+/// calls per thread survive). The ring of an exited thread keeps its records until a new thread takes it over,
+/// so the number of rings stays at the peak number of recording threads; the trace `tid` identifies the ring.
+/// The rings can be dumped at any time, e.g. when an event loop stalls, as Chrome trace / Perfetto JSON:
+///
+///     constexpr vx::cfg::function traced = { .trace_invocations = true };
+///     vx::func<void(), traced> handler = ...;
+///     ...
+///     vx::flight_recorder::save_chrome_json("stall.json"); ///< open in chrome://tracing or ui.perfetto.dev
+///
+/// Funcs without trace_invocations are unaffected; plain function pointers on the fptr fast path are not recorded.
+
+#include <algorithm> // std::min
+#include <atomic>
+#include <cstdint>
+#include <cstdio> // std::FILE
+#include <string_view>
+#include <vector>
+#include "func.hpp"
+#include "time.hpp"
+#include "type_registry.hpp"
+
+#if !defined VX_FLIGHT_RECORDER_CAPACITY
+    #define VX_FLIGHT_RECORDER_CAPACITY 4096
+#endif
+
+namespace vx::flight_recorder {
+
+inline constexpr std::size_t capacity = VX_FLIGHT_RECORDER_CAPACITY;
+static_assert((capacity & (capacity - 1)) == 0, "VX_FLIGHT_RECORDER_CAPACITY has to be a power of two");
+
+inline constexpr std::size_t max_types = vx::detail::type_registry::max_types;
+
+namespace detail {
+
+/// Written by the owning thread only; relaxed atomics so that dumps from other threads are race-free
+struct record {
+    std::atomic<std::uint64_t> start;
+    std::atomic<std::uint64_t> end;
+    std::atomic<std::uint32_t> type;
+};
+
+struct ring {
+    std::uint32_t thread;
+    ring * next;
+    std::atomic<bool> in_use {true};
+    std::atomic<std::uint64_t> written {0}; ///< keeps counting across owners, so dumps stay consistent
+    record records [capacity] {};
+};
+
+inline std::atomic<ring*> rings {nullptr};
+inline std::atomic<std::uint32_t> ring_count {0};
+
+/// A released ring (its thread exited) or a new one; rings are never freed, so dumps can walk the list any time
+inline ring* acquire_ring() {
+    for (auto * r = rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        bool free = false;
+        if (r->in_use.compare_exchange_strong(free, true, std::memory_order_acquire)) { return r; }
+    }
+    auto * r = new ring{};
+    r->thread = ring_count.fetch_add(1, std::memory_order_relaxed);
+    r->next = rings.load(std::memory_order_relaxed);
+    while (!rings.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+    return r;
+}
+
+/// Ring of the calling thread, released when the thread exits; nullptr for calls made while the thread's
+/// thread_local objects are being destroyed after the release (those calls are not recorded)
+inline ring* this_thread_ring() {
+    thread_local ring * mine = nullptr;
+    thread_local bool released = false;
+    struct releaser {
+        ~releaser() {
+            mine->in_use.store(false, std::memory_order_release);
+            mine = nullptr;
+            released = true;
+        }
+    };
+    if (mine == nullptr && !released) {
+        mine = acquire_ring();
+        thread_local releaser release_at_exit;
+    }
+    return mine;
+}
+
+template <typename F>
+std::uint32_t type_id() noexcept {
+    return vx::detail::type_registry::id<F>(vx::detail::type_name<F>());
+}
+
+inline void write_json_string(std::FILE * out, std::string_view text) {
+    std::fputc('"', out);
+    for (char c : text) {
+        if (c == '"' || c == '\\') { std::fputc('\\', out); }
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+} // namespace detail
+
+/// RAII record of one invocation of F, placed in the invoker by func_base
+template <typename F>
+class scope {
+public:
+    scope() noexcept : start{ time::counter::now() } {}
+
+    ~scope() {
+        const auto end = time::counter::now();
+        auto * ring = detail::this_thread_ring();
+        if (ring == nullptr) { return; }
+        const auto n = ring->written.load(std::memory_order_relaxed);
+        auto& r = ring->records[n & (capacity - 1)];
+        r.start.store(start, std::memory_order_relaxed);
+        r.end.store(end, std::memory_order_relaxed);
+        r.type.store(detail::type_id<F>(), std::memory_order_relaxed);
+        ring->written.store(n + 1, std::memory_order_release);
+    }
+
+    scope(scope const&) = delete;
+    scope& operator= (scope const&) = delete;
+
+private:
+    std::uint64_t start;
+};
+
+/// Writes the records of all threads as Chrome trace JSON ("X" complete events, microseconds);
+/// records overwritten while dumping are skipped
+inline bool dump_chrome_json(std::FILE * out) {
+    struct entry { std::uint64_t start, end; std::uint32_t type, thread; };
+    std::vector<entry> entries;
+    std::uint64_t origin = ~std::uint64_t{0};
+
+    for (auto * ring = detail::rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+        const auto written = ring->written.load(std::memory_order_acquire);
+        const auto first = written > capacity ? written - capacity : 0;
+        const auto size_before = entries.size();
+        for (auto i = first; i < written; ++i) {
+            auto const& r = ring->records[i & (capacity - 1)];
+            entries.push_back({ r.start.load(std::memory_order_relaxed), r.end.load(std::memory_order_relaxed),
+                                r.type.load(std::memory_order_relaxed), ring->thread });
+        }
+        /// The owner kept running: drop whatever may have been (or is being) overwritten meanwhile
+        const auto now_written = ring->written.load(std::memory_order_acquire) + 1;
+        const auto overwritten = now_written > capacity ? std::min(now_written - capacity, written) : 0;
+        if (overwritten > first) {
+            entries.erase(entries.begin() + std::ptrdiff_t(size_before), entries.begin() + std::ptrdiff_t(size_before + (overwritten - first)));
+        }
+    }
+    for (auto const& e : entries) { origin = std::min(origin, e.start); }
+
+    const double ticks_per_us = time::counter::ticks_per_ns() * 1000.0;
+
+    std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool first_event = true;
+    for (auto const& e : entries) {
+        std::fprintf(out, "%s\n{\"name\":", first_event ? "" : ",");
+        detail::write_json_string(out, vx::detail::type_registry::name(e.type));
+        std::fprintf(out, ",\"cat\":\"vx::func\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            double(e.start - origin) / ticks_per_us, double(e.end - e.start) / ticks_per_us, static_cast<unsigned>(e.thread));
+        first_event = false;
+    }
+    std::fprintf(out, "\n]}\n");
+    return std::ferror(out) == 0;
+}
+
+inline bool save_chrome_json(const char * path) {
+    std::FILE * out = std::fopen(path, "w");
+    if (out == nullptr) { return false; }
+    const bool written = dump_chrome_json(out);
+    return std::fclose(out) == 0 && written;
+}
+
+} // namespace vx::flight_recorder
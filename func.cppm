@@ -0,0 +1,51 @@
+/// C++20 named module for func.hpp:
+///
+///     import vx.func;
+///     vx::func<int(int)> f = [](int x){ return x + 1; };
+///
+/// The header (and with it every standard include) is parsed once, in the global module fragment,
+/// and the public API is re-exported with using-declarations. Configuration macros (VX_FUNC_*) have to be
+/// defined when building the module, and macros such as VX_FUNC_EXTERN_TEMPLATE are only available from the header.
+///
+///   g++ -std=c++20 -fmodules-ts -x c++ -c func.cppm       (BMI in gcm.cache/; GCC 12 builds it but importers do not see the names)
+///   clang++ -std=c++20 --precompile func.cppm -o vx.func.pcm
+
+module;
+
+#include "func.hpp"
+
+export module vx.func;
+
+export namespace vx::cfg {
+    using vx::cfg::func;
+    using vx::cfg::function;
+}
+
+export namespace vx {
+    using vx::func;
+    using vx::move_only_func;
+    using vx::basic_func_variant;
+    using vx::func_variant;
+    using vx::is_sbo_eligible;
+
+    using vx::nontype_t;
+    using vx::nontype;
+
+    using vx::bad_function_call;
+    using vx::bad_function_operation;
+
+    using vx::no_heap_scope;
+}
+
+#if defined VX_FUNC_SBO_ADVISOR
+export namespace vx::sbo_advisor {
+    using vx::sbo_advisor::report;
+}
+#endif
+
+#if defined VX_FUNC_TRACE
+export namespace vx::trace {
+    using vx::trace::save;
+    using vx::trace::clear;
+}
+#endif
@@ -2,11 +2,28 @@
 
 #include <algorithm> // std::max
 #include <concepts> // std::invocable_r
+#include <cstddef> // std::max_align_t
+#include <cstdint> // std::uint8_t
 #include <exception> // std::exception
 #include <functional> // std::invoke
 #include <memory> // std::addressof
+#include <new> // std::launder
+#include <string_view> // detail::type_name
+#include <tuple> // std::tuple_element_t
 #include <type_traits>
 #include <utility> // std::size_t
+#if defined VX_FUNC_SBO_ADVISOR
+    #include <atomic>
+    #include <cstdio> // std::fprintf
+#endif
+#if defined VX_FUNC_HEAP_GUARD
+    #include <array>
+#endif
+#if defined VX_FUNC_TRACE
+    #include <atomic>
+    #include <cstdio> // std::fopen
+    #include "type_registry.hpp"
+#endif
 
 #if defined __GNUC__ // GCC, Clang
     #define VX_UNREACHABLE() __builtin_unreachable()
@@ -16,6 +33,28 @@
     #define VX_UNREACHABLE()
 #endif
 
+/// Invokers are hot, management actions (move/copy/dtor/typeinfo) are cold and kept out of line,
+/// so that they are grouped apart (.text.hot / .text.unlikely) and don't dilute the i-cache
+#if defined VX_FUNC_NO_HOT_COLD // opt-out (e.g. for the layout benchmark baseline)
+    #define VX_HOT
+    #define VX_COLD
+#elif defined __GNUC__ // GCC, Clang
+    #define VX_HOT __attribute__((hot))
+    #define VX_COLD __attribute__((cold, noinline))
+#elif defined _MSC_VER // MSVC
+    #define VX_HOT
+    #define VX_COLD __declspec(noinline)
+#else 
+    #define VX_HOT
+    #define VX_COLD
+#endif
+
+#if defined __clang__
+    #define VX_TRIVIAL_ABI [[clang::trivial_abi]]
+#else 
+    #define VX_TRIVIAL_ABI
+#endif
+
 namespace vx {
 
 namespace cfg {
@@ -23,13 +62,21 @@ struct func {
     std::size_t SBO { 32 };
     std::size_t alignment { alignof(std::max_align_t) };
     bool allow_return_type_conversion { true };
+    bool allow_signature_adaptation { false }; ///< converting moves from other signatures keep the storage (+1 pointer)
     bool require_nothrow_relocatable { false }; //!TODO: Implement support for [p1144][p3236]
+    /// Bitwise relocatable func that can be passed in registers. Together with allow_heap = false and no typeinfo
+    /// the func is trivially copyable (SBO + invoker only): then moves are plain copies, so a moved-from func still
+    /// holds (and can invoke) its callable instead of being empty, and function pointers are stored in the SBO like
+    /// any other callable (optimize_for_func_ptrs has no effect)
+    bool trivial_abi { false };
     bool require_nothrow_invocable { false };
     bool require_nothrow_copyable { false };
     bool require_const_invocable { false };
+    bool require_rvalue_invocable { false };
     bool require_nothrow_movable { true };
     bool optimize_for_func_ptrs { true };
     bool enable_typeinfo { false };
+    bool trace_invocations { false }; ///< flight recorder around every invocation (include flight_recorder.hpp)
     bool can_be_empty { false };
     bool check_empty { false };
     bool allow_heap { true };
@@ -49,6 +96,18 @@ struct func {
         return copy;
     }
 
+    [[nodiscard]] constexpr func with_rvalue_invocable(bool state) const noexcept {
+        func copy = *this;
+        copy.require_rvalue_invocable = state;
+        return copy;
+    }
+
+    [[nodiscard]] constexpr func with_can_be_empty(bool state) const noexcept {
+        func copy = *this;
+        copy.can_be_empty = state;
+        return copy;
+    }
+
     constexpr bool has_empty_state() const noexcept {
         return can_be_empty || check_empty;
     }
@@ -72,8 +131,378 @@ private:
     const char * const error_message = "";
 };
 
+/// @brief Compile-time known callable (function, member pointer, ...), P2511-style: 
+///        vx::func<int(int)> f = vx::nontype<&foo>; ///< nothing stored, foo is inlined into the invoker
+///        vx::func<int()> g {vx::nontype<&X::bar>, &x}; ///< only the bound first argument is stored
+template <auto V>
+struct nontype_t {
+    explicit nontype_t() = default;
+
+    template <typename... Args> requires std::invocable<decltype(V), Args...>
+    constexpr decltype(auto) operator() (Args&&... args) const noexcept(std::is_nothrow_invocable_v<decltype(V), Args...>) {
+        return std::invoke(V, std::forward<Args>(args)...);
+    }
+};
+
+template <auto V>
+inline constexpr nontype_t<V> nontype {};
+
+#if defined VX_FUNC_SBO_ADVISOR
+/// Opt-in SBO sizing advisor (define VX_FUNC_SBO_ADVISOR before including): every func_base(F&&) construction
+/// records sizeof(F) into a histogram per (SBO, alignment, allow_heap) configuration, or, if F cannot be stored
+/// inline whatever the SBO (over-aligned, throwing move with require_nothrow_movable, not trivially copyable with
+/// trivial_abi), counts it as ineligible. report() lists, for candidate SBO sizes, the share of callables stored
+/// inline, the heap fallbacks and the estimated memory cost; it runs at exit unless VX_FUNC_SBO_ADVISOR_NO_REPORT is defined.
+namespace sbo_advisor {
+
+inline constexpr std::size_t granularity = 8;
+inline constexpr std::size_t largest = 512; ///< bigger callables share the last bucket
+inline constexpr std::size_t bucket_count = largest / granularity + 2;
+
+struct histogram {
+    std::size_t SBO;
+    std::size_t alignment;
+    bool allow_heap;
+    std::atomic<std::uint64_t> sizes [bucket_count] {}; ///< [i]: eligible callables of (i-1)*granularity+1 .. i*granularity bytes
+    std::atomic<std::uint64_t> ineligible {0}; ///< on the heap whatever the SBO
+    std::atomic<std::uint64_t> ineligible_bytes {0};
+    std::atomic<bool> linked {false};
+    histogram * next = nullptr;
+};
+
+inline std::atomic<histogram*> histograms {nullptr};
+
+template <cfg::function cfg>
+inline constinit histogram histogram_for { cfg.SBO, cfg.alignment, cfg.allow_heap };
+
+/// @param eligible - F could be stored inline given a large enough SBO
+template <cfg::function cfg>
+void record(std::size_t size, bool eligible) noexcept {
+    auto& h = histogram_for<cfg>;
+    if (!h.linked.load(std::memory_order_relaxed) && !h.linked.exchange(true, std::memory_order_acq_rel)) {
+        h.next = histograms.load(std::memory_order_relaxed);
+        while (!histograms.compare_exchange_weak(h.next, &h, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+    if (!eligible) {
+        h.ineligible.fetch_add(1, std::memory_order_relaxed);
+        h.ineligible_bytes.fetch_add(size, std::memory_order_relaxed);
+    } else {
+        const auto bucket = std::min((size + granularity - 1) / granularity, bucket_count - 1);
+        h.sizes[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/// @param coverage - share of constructions that the recommended SBO keeps off the heap
+inline void report(std::FILE * out = stderr, double coverage = 0.99) {
+    constexpr std::size_t candidates [] = { 0, 8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+    constexpr std::size_t pointers = 2 * sizeof(void*); ///< invoker + actions
+
+    for (auto * h = histograms.load(std::memory_order_acquire); h != nullptr; h = h->next) {
+        std::uint64_t counts [bucket_count];
+        const auto ineligible = h->ineligible.load(std::memory_order_relaxed);
+        std::uint64_t total = ineligible;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            counts[i] = h->sizes[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) { continue; }
+
+        std::fprintf(out, "vx::func SBO advisor: SBO=%zu alignment=%zu heap=%s, %llu constructions (%llu never inline)\n",
+            h->SBO, h->alignment, h->allow_heap ? "yes" : "no",
+            static_cast<unsigned long long>(total), static_cast<unsigned long long>(ineligible));
+        /// Without heap every construction is inline: a smaller SBO rejects the bigger callables at compile time
+        if (h->allow_heap) {
+            std::fprintf(out, "       SBO  inline%%   fallbacks  object bytes  est. total bytes\n");
+        } else {
+            std::fprintf(out, "       SBO  compiles%%  object bytes  (no heap: fallbacks would be compile errors)\n");
+        }
+
+        std::size_t recommended = largest;
+        bool found = false;
+        for (auto candidate : candidates) {
+            std::uint64_t inlined = 0, heap_bytes = h->ineligible_bytes.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                const auto size = i * granularity; ///< upper bound of the bucket (the last one is "more than largest")
+                if (size <= candidate) { inlined += counts[i]; }
+                else { heap_bytes += counts[i] * size; }
+            }
+            const auto fallbacks = total - inlined;
+            const auto object = (std::max(candidate, std::size_t{1}) + pointers + h->alignment - 1) / h->alignment * h->alignment;
+            if (h->allow_heap) {
+                std::fprintf(out, "  %c %6zu  %6.2f%%  %10llu  %12zu  %16llu\n",
+                    candidate == h->SBO ? '*' : ' ', candidate, 100.0 * double(inlined) / double(total),
+                    static_cast<unsigned long long>(fallbacks), object,
+                    static_cast<unsigned long long>(total * object + heap_bytes));
+            } else {
+                std::fprintf(out, "  %c %6zu  %8.2f%%  %12zu\n",
+                    candidate == h->SBO ? '*' : ' ', candidate, 100.0 * double(inlined) / double(total), object);
+            }
+            if (!found && double(inlined) >= coverage * double(total)) {
+                recommended = candidate;
+                found = true;
+            }
+        }
+        std::fprintf(out, "  recommended SBO for %.1f%% inline: %s%zu\n\n", 100.0 * coverage, found ? "" : "> ", recommended);
+    }
+}
+
+#if !defined VX_FUNC_SBO_ADVISOR_NO_REPORT
+namespace detail {
+inline const struct report_at_exit {
+    ~report_at_exit() { report(); }
+} reporter {};
+} // namespace detail
+#endif
+
+} // namespace sbo_advisor
+#endif
+
+/// @brief Forbids heap allocations by vx::func on this thread while alive (nestable):
+///        with VX_FUNC_HEAP_GUARD defined, storing a callable that doesn't fit the SBO or copying a heap-stored one
+///        throws vx::bad_function_operation naming the callable type (std::terminate where the copy is noexcept).
+///        Without VX_FUNC_HEAP_GUARD it compiles to nothing, so it can stay in release code.
+class no_heap_scope;
+
+namespace detail {
+
+/// Readable name of F without RTTI (heap guard, tracing, flight recorder)
+template <typename F>
+constexpr std::string_view type_name() noexcept {
+#if defined __clang__ || defined __GNUC__
+    constexpr std::string_view signature = __PRETTY_FUNCTION__; ///< "... [with F = X; ...]" / "... [F = X]"
+    constexpr auto begin = signature.find("F = ") + 4;
+    return signature.substr(begin, signature.find_first_of(";]", begin) - begin);
+#elif defined _MSC_VER
+    constexpr std::string_view signature = __FUNCSIG__; ///< "... type_name<X>(void) noexcept"
+    constexpr auto begin = signature.find("type_name<") + 10;
+    return signature.substr(begin, signature.rfind(">(void)") - begin);
+#else
+    return "(unknown type)";
+#endif
+}
+
+} // namespace detail
+
+#if defined VX_FUNC_HEAP_GUARD
 namespace detail {
 
+inline thread_local std::size_t no_heap_depth = 0;
+
+template <typename F>
+struct heap_violation {
+    static constexpr std::string_view prefix = "heap allocation inside vx::no_heap_scope: ";
+    static constexpr auto message = []{
+        std::array<char, prefix.size() + type_name<F>().size() + 1> text {};
+        std::copy(prefix.begin(), prefix.end(), text.begin());
+        std::copy(type_name<F>().begin(), type_name<F>().end(), text.begin() + prefix.size());
+        return text;
+    }();
+};
+
+} // namespace detail
+
+class no_heap_scope {
+public:
+    no_heap_scope() noexcept { ++detail::no_heap_depth; }
+    ~no_heap_scope() { --detail::no_heap_depth; }
+    no_heap_scope(no_heap_scope const&) = delete;
+    no_heap_scope& operator= (no_heap_scope const&) = delete;
+};
+#else
+class no_heap_scope {
+public:
+    no_heap_scope() noexcept {}
+    ~no_heap_scope() {} ///< user-provided, so guards aren't reported as unused variables
+    no_heap_scope(no_heap_scope const&) = delete;
+    no_heap_scope& operator= (no_heap_scope const&) = delete;
+};
+#endif
+
+#if defined VX_FUNC_TRACE
+/// Opt-in invocation trace (define VX_FUNC_TRACE before including): every call of a stored callable appends
+/// {callable type, object address} to a global buffer of VX_FUNC_TRACE_CAPACITY events (later calls are dropped).
+/// vx::trace::save(path) writes the types and the call sequence in the text format read by bench/replay.cpp.
+namespace trace {
+
+#if !defined VX_FUNC_TRACE_CAPACITY
+    #define VX_FUNC_TRACE_CAPACITY (1u << 20)
+#endif
+
+inline constexpr std::size_t capacity = VX_FUNC_TRACE_CAPACITY;
+inline constexpr std::size_t max_types = detail::type_registry::max_types;
+
+struct event {
+    std::uint32_t type;
+    const void * object;
+};
+
+inline constinit event events [capacity] {};
+inline std::atomic<std::size_t> event_count {0};
+inline constinit std::size_t argument_bytes [max_types] {}; ///< sum of sizeof(Args) per type ID (of its first traced signature)
+
+template <typename F, typename... Args>
+std::uint32_t type_id() noexcept {
+    static const std::uint32_t id = [] {
+        const auto id = detail::type_registry::id<F>(detail::type_name<F>());
+        if (id < max_types) { argument_bytes[id] = (sizeof(Args) + ... + 0); }
+        return id;
+    }();
+    return id;
+}
+
+template <typename F, typename... Args>
+void record(const void * object) noexcept {
+    const auto i = event_count.fetch_add(1, std::memory_order_relaxed);
+    if (i < capacity) { events[i] = { type_id<F, Args...>(), object }; }
+}
+
+/// Format: "vx-func-trace 1", "types N", N x "<id> <size> <alignment> <argument bytes> <name>",
+///         "events M", M x "<type id> <object address>"
+inline bool save(const char * path) {
+    std::FILE * out = std::fopen(path, "w");
+    if (out == nullptr) { return false; }
+    const auto type_total = detail::type_registry::size();
+    const auto event_total = std::min(event_count.load(std::memory_order_acquire), capacity);
+    std::fprintf(out, "vx-func-trace 1\ntypes %zu\n", type_total);
+    for (std::size_t i = 0; i < type_total; ++i) {
+        const auto id = static_cast<std::uint32_t>(i);
+        const bool known = detail::type_registry::complete(id);
+        const auto name = detail::type_registry::name(id);
+        std::fprintf(out, "%zu %zu %zu %zu %.*s\n", i, known ? detail::type_registry::types[i].size : 0,
+            known ? detail::type_registry::types[i].alignment : 0, argument_bytes[i],
+            static_cast<int>(name.size()), name.data());
+    }
+    std::fprintf(out, "events %zu\n", event_total);
+    for (std::size_t i = 0; i < event_total; ++i) {
+        std::fprintf(out, "%u %p\n", static_cast<unsigned>(events[i].type), events[i].object);
+    }
+    return std::fclose(out) == 0;
+}
+
+inline void clear() noexcept { event_count.store(0, std::memory_order_relaxed); }
+
+} // namespace trace
+#endif
+
+namespace detail {
+
+/// Allocation hook of func_base: enforces no_heap_scope (VX_FUNC_HEAP_GUARD only)
+template <typename F>
+void on_heap_allocation() {
+#if defined VX_FUNC_HEAP_GUARD
+    if (no_heap_depth != 0) { throw bad_function_operation{ heap_violation<F>::message.data() }; }
+#endif
+}
+
+/// nontype<V> with a bound first argument
+template <auto V, typename T>
+struct bound_nontype {
+    T bound;
+
+    template <typename... Args> requires std::invocable<decltype(V), T&, Args...>
+    constexpr decltype(auto) operator() (Args&&... args) noexcept(std::is_nothrow_invocable_v<decltype(V), T&, Args...>) {
+        return std::invoke(V, bound, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> requires std::invocable<decltype(V), T const&, Args...>
+    constexpr decltype(auto) operator() (Args&&... args) const noexcept(std::is_nothrow_invocable_v<decltype(V), T const&, Args...>) {
+        return std::invoke(V, bound, std::forward<Args>(args)...);
+    }
+};
+
+/// Fused interceptor chain: Interceptor::around(next, args...) if present, else before(args const&...) / after();
+/// run() is noexcept exactly when the callable and every hook of the chain are
+template <typename... Interceptors>
+struct interceptor_chain {
+    template <typename F, typename... Args>
+    static constexpr bool nothrow = std::is_nothrow_invocable_v<F, Args...>;
+
+    template <typename F, typename... Args>
+    static decltype(auto) run(F&& f, Args&&... args) noexcept(nothrow<F, Args...>) {
+        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+};
+
+template <typename Interceptor, typename... Interceptors>
+struct interceptor_chain<Interceptor, Interceptors...> {
+    using rest = interceptor_chain<Interceptors...>;
+
+    /// The `next` handed to around(): the rest of the chain
+    template <typename F>
+    struct next_call {
+        F&& f;
+
+        template <typename... Args>
+        decltype(auto) operator() (Args&&... args) const noexcept(rest::template nothrow<F, Args...>) {
+            return rest::run(std::forward<F>(f), std::forward<Args>(args)...);
+        }
+    };
+
+    template <typename F, typename... Args>
+    static constexpr bool has_around = requires (next_call<F>& next, Args&&... args) { Interceptor::around(next, std::forward<Args>(args)...); };
+
+    template <typename F, typename... Args>
+    static constexpr bool nothrow = [] {
+        if constexpr (has_around<F, Args...>) {
+            return noexcept(Interceptor::around(std::declval<next_call<F>&>(), std::declval<Args>()...));
+        } else {
+            bool hooks = rest::template nothrow<F, Args...>;
+            if constexpr (requires { Interceptor::before(std::declval<Args const&>()...); }) {
+                hooks = hooks && noexcept(Interceptor::before(std::declval<Args const&>()...));
+            }
+            if constexpr (requires { Interceptor::after(); }) {
+                hooks = hooks && noexcept(Interceptor::after());
+            }
+            return hooks;
+        }
+    }();
+
+    struct after_guard {
+        ~after_guard() noexcept(noexcept(Interceptor::after())) { Interceptor::after(); }
+    };
+
+    template <typename F, typename... Args>
+    static decltype(auto) run(F&& f, Args&&... args) noexcept(nothrow<F, Args...>) {
+        next_call<F> next { std::forward<F>(f) };
+        if constexpr (has_around<F, Args...>) {
+            return Interceptor::around(next, std::forward<Args>(args)...);
+        } else {
+            if constexpr (requires { Interceptor::before(std::as_const(args)...); }) {
+                Interceptor::before(std::as_const(args)...);
+            }
+            if constexpr (requires { Interceptor::after(); }) {
+                [[maybe_unused]] after_guard guard;
+                return next(std::forward<Args>(args)...);
+            } else {
+                return next(std::forward<Args>(args)...);
+            }
+        }
+    }
+};
+
+/// Callable F wrapped with stateless interceptors: same size as F, hooks inlined into its invoker
+template <typename F, typename... Interceptors>
+struct intercepted {
+    using chain = interceptor_chain<Interceptors...>;
+
+    F callable;
+
+    template <typename... Args> requires std::invocable<F&, Args...>
+    constexpr decltype(auto) operator() (Args&&... args) & noexcept(chain::template nothrow<F&, Args...>) {
+        return chain::run(callable, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> requires std::invocable<F const&, Args...>
+    constexpr decltype(auto) operator() (Args&&... args) const& noexcept(chain::template nothrow<F const&, Args...>) {
+        return chain::run(callable, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> requires std::invocable<F&&, Args...>
+    constexpr decltype(auto) operator() (Args&&... args) && noexcept(chain::template nothrow<F&&, Args...>) {
+        return chain::run(std::move(callable), std::forward<Args>(args)...);
+    }
+};
+
 // Allocator wrapper
 template <typename F, typename Allocator>
 struct with_allocator {
@@ -85,6 +514,33 @@ struct with_allocator {
 #endif
 };
 
+/// Placeholder for optional members (used with [[no_unique_address]])
+struct empty_slot {};
+
+} // namespace detail
+
+/// Defined in flight_recorder.hpp: RAII record of one invocation of F (cfg.trace_invocations)
+namespace flight_recorder {
+template <typename F>
+class scope;
+} // namespace flight_recorder
+
+namespace detail {
+
+enum class dispatch_tag { Dtor, Move, Copy, GetPtr, TypeInfo };
+
+/// Empty member that keeps [[clang::trivial_abi]] from taking effect unless the configuration asks for it
+template <bool trivial_abi>
+struct abi_guard {};
+
+template <>
+struct abi_guard<false> {
+    abi_guard() = default;
+    abi_guard(abi_guard const&) noexcept {} ///< non-trivial for the purposes of calls
+    abi_guard& operator= (abi_guard const&) = default;
+    ~abi_guard() {}
+};
+
 // SBO memory
 template <std::size_t capacity, std::size_t alignment>
 union memory_SBO {
@@ -134,8 +590,10 @@ union memory_SBO {
         new(dest) F(this->as_sbo<F>());
     }
 
+    /// Not noexcept even for nothrow-copyable F: the allocation may throw (std::bad_alloc, no_heap_scope)
     template <typename F>
-    void copy_into_ptr(memory_SBO * dest) const noexcept(std::is_nothrow_copy_constructible_v<F>) {
+    void copy_into_ptr(memory_SBO * dest) const {
+        on_heap_allocation<F>();
         dest->template ptr_to<F>() = new F(*this->ptr_to<F>());
     }
 
@@ -147,14 +605,27 @@ union memory_SBO {
 };
 
 
+#if defined __clang__
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wignored-attributes" // trivial_abi is switched off by abi_guard<false> on purpose
+#endif
+
+/// With cfg.trivial_abi the object is bitwise relocatable (SBO holds trivially copyable callables only,
+/// everything else goes to the heap), so Clang may pass it in registers and moves are plain copies
 template <cfg::function cfg, typename R, typename... Args>
-class func_base {
+class VX_TRIVIAL_ABI func_base {
 public:
     template <typename F>
     static constexpr bool is_sbo_eligible = sizeof(F) <= cfg.SBO && ///< fits into SBO buffer
                                      alignof(F) <= cfg.alignment && ///< and has lower alignment
                                      (cfg.alignment % alignof(F) == 0) && 
-                                     (!cfg.require_nothrow_movable || std::is_nothrow_move_constructible_v<F>);
+                                     (!cfg.require_nothrow_movable || std::is_nothrow_move_constructible_v<F>) &&
+                                     (!cfg.trivial_abi || std::is_trivially_copyable_v<F>);
+
+    /// F's result converts implicitly to R, and is R unless cfg.allow_return_type_conversion (any result for void R)
+    template <typename F>
+    static constexpr bool returns_r = std::is_void_v<R> || (std::is_invocable_r_v<R, F, Args...> &&
+        (cfg.allow_return_type_conversion || std::is_same_v<R, std::invoke_result_t<F, Args...>>));
 
     // template <>
     // static constexpr bool is_sbo_eligible<R (*)(Args...)> = sizeof(R (*)(Args...)) <= cfg.SBO && 
@@ -170,7 +641,6 @@ private:
     static constexpr bool is_tagfunc_nothrow_movable = (cfg.require_nothrow_movable || not cfg.movable) && (cfg.require_nothrow_copyable || not cfg.copyable);
     static constexpr bool has_multiple_actions = (cfg.movable || cfg.copyable || cfg.enable_typeinfo);
 
-    enum class dispatch_tag { Dtor, Move, Copy, GetPtr, TypeInfo };
     using p_cleanup = void (*)(memory&) noexcept;
     using p_tagfunc = void (*)(dispatch_tag, memory&, memory*) noexcept(is_tagfunc_nothrow_movable);
     using action_f = std::conditional_t<has_multiple_actions, p_tagfunc, p_cleanup>; 
@@ -180,23 +650,27 @@ private:
         invoker_type>;
 
     template <typename F>
-    static constexpr p_cleanup dtor_action =  +[](memory& mem) noexcept { 
+    static void release(memory& mem) noexcept {
         if constexpr (is_sbo_eligible<F>) {
             mem.template del_sbo<F>(); 
         } else {
             mem.template del_ptr<F>();
         }
-    };
+    }
 
     template <typename F>
-    static constexpr p_tagfunc multiple_actions = +[](dispatch_tag cmd, memory& mem, memory* new_mem=nullptr) noexcept(is_tagfunc_nothrow_movable) { 
+    VX_COLD static void cleanup(memory& mem) noexcept { 
+        release<F>(mem);
+    }
+
+    template <typename F>
+    static constexpr p_cleanup dtor_action = &cleanup<F>;
+
+    template <typename F>
+    VX_COLD static void manage(dispatch_tag cmd, memory& mem, memory* new_mem) noexcept(is_tagfunc_nothrow_movable) { 
         switch (cmd) {
             case dispatch_tag::Dtor: {
-                if constexpr (is_sbo_eligible<F>) {
-                    mem.template del_sbo<F>();
-                } else {
-                    mem.template del_ptr<F>();
-                }
+                release<F>(mem);
             } break;
 
             case dispatch_tag::Move: {
@@ -246,7 +720,10 @@ private:
                 }
             } break;
         }
-    };
+    }
+
+    template <typename F>
+    static constexpr p_tagfunc multiple_actions = &manage<F>;
 
     template <typename F>
     static auto& as_invocable(const_correct<memory>& mem) noexcept {
@@ -257,10 +734,30 @@ private:
         }
     }
 
+    /// Destroys the stored callable on scope exit (used by the one-shot `&&` invokers)
+    template <typename F>
+    struct destroy_on_exit {
+        memory& mem;
+        ~destroy_on_exit() { release<F>(mem); }
+    };
+
     template <typename F>
-    static constexpr invoker_type caller_for = +[](const_correct<memory>& mem, Args... args) noexcept(cfg.require_nothrow_invocable) {
+    VX_HOT static R invoke_stored(const_correct<memory>& mem, Args... args) noexcept(cfg.require_nothrow_invocable) {
+#if defined VX_FUNC_TRACE
+        trace::record<F, Args...>(&mem);
+#endif
+        [[maybe_unused]] std::conditional_t<cfg.trace_invocations, flight_recorder::scope<F>, empty_slot> recorded;
         auto& f = as_invocable<F>(mem);
-        if constexpr (cfg.allow_return_type_conversion) {
+        if constexpr (cfg.require_rvalue_invocable) { /// invoke as rvalue and destroy in the same call
+            destroy_on_exit<F> guard {mem};
+            if constexpr (std::is_void_v<R>) {
+                std::move(f)(std::forward<Args>(args)...);
+            } else if constexpr (cfg.allow_return_type_conversion) {
+                return R( std::move(f)(std::forward<Args>(args)...) );
+            } else {
+                return std::move(f)(std::forward<Args>(args)...);
+            }
+        } else if constexpr (cfg.allow_return_type_conversion) {
             if constexpr (!std::is_void_v<R>) { 
                 return R( f(args...) ); 
             } else {
@@ -269,11 +766,61 @@ private:
         } else {
             return f(args...);
         }
-    };
+    }
 
+    template <typename F>
+    static constexpr invoker_type caller_for = &invoke_stored<F>;
+
+
+    /// Invoker of a func adapted from another signature: `adapted` holds the Source's invoker,
+    /// the storage and the actions are the Source's ones
+    template <typename Source>
+    VX_HOT static R invoke_adapted(const_correct<memory>& mem, Args... args) noexcept(cfg.require_nothrow_invocable) {
+        static_assert(std::is_standard_layout_v<func_base>, "data has to be pointer-interconvertible with func_base");
+        auto& self = reinterpret_cast<const_correct<func_base>&>(mem); ///< data is the first member
+        auto inner = reinterpret_cast<typename Source::invoker_type>(self.adapted);
+        if constexpr (std::is_void_v<R>) {
+            inner(mem, std::forward<Args>(args)...);
+        } else {
+            return R( inner(mem, std::forward<Args>(args)...) );
+        }
+    }
 
-    static constexpr invoker_type empty_call = +[]([[maybe_unused]] const_correct<memory>& mem, Args...) {
-        throw vx::bad_function_call{};
+    template <typename Source>
+    static constexpr invoker_type adapter_for = &invoke_adapted<Source>;
+
+    /// Source's storage can be taken over as is: same memory layout & actions, 
+    /// compatible signature and no requirements the Source doesn't meet
+    template <cfg::function cfg2, typename R2, typename... Args2>
+    static constexpr bool adaptable_from = [] {
+        using source = func_base<cfg2, R2, Args2...>;
+        if constexpr (!cfg.allow_signature_adaptation || cfg2.allow_signature_adaptation || !cfg2.movable) {
+            return false;
+        } else {
+            return std::is_same_v<memory, typename source::memory> 
+                && std::is_same_v<action_f, typename source::action_f>
+                && std::is_invocable_r_v<R, R2 (*)(Args2...), Args...>
+                && (cfg.allow_return_type_conversion || std::is_void_v<R> || std::is_same_v<R, R2>)
+                && (!cfg.require_nothrow_invocable || cfg2.require_nothrow_invocable)
+                && (!cfg.require_const_invocable || cfg2.require_const_invocable)
+                && (cfg.require_rvalue_invocable == cfg2.require_rvalue_invocable)
+                && (!cfg.trivial_abi || cfg2.trivial_abi)
+                && (!cfg.enable_typeinfo || cfg2.enable_typeinfo)
+                && (!cfg.copyable || cfg2.copyable)
+                && (!cfg2.optimize_for_func_ptrs || cfg.allow_heap || is_sbo_eligible<R2 (*)(Args2...)>);
+        }
+    }();
+
+    template <cfg::function cfg2, typename R2, typename... Args2>
+    static constexpr bool is_adaptable_source(func_base<cfg2, R2, Args2...> *) { return adaptable_from<cfg2, R2, Args2...>; }
+    static constexpr bool is_adaptable_source(...) { return false; }
+
+    template <cfg::function, typename, typename...>
+    friend class func_base;
+
+    static constexpr invoker_type empty_call = +[]([[maybe_unused]] const_correct<memory>& mem, Args...) noexcept(cfg.require_nothrow_invocable) -> R {
+        if constexpr (cfg.require_nothrow_invocable) { std::terminate(); }
+        else { throw vx::bad_function_call{}; }
     };
 
     static constexpr p_tagfunc noop_actions = +[](dispatch_tag, memory&, memory*) noexcept {};
@@ -303,48 +850,78 @@ public:
 
     template <std::invocable<Args...> F>
     func_base (F && callable) requires (
-        !std::derived_from<std::remove_cvref_t<F>, func_base> &&
+        !std::derived_from<std::remove_cvref_t<F>, func_base> && returns_r<std::decay_t<F>&> &&
+        !(std::is_rvalue_reference_v<F&&> && is_adaptable_source(static_cast<std::remove_reference_t<F>*>(nullptr))) &&
         (cfg.allow_heap || is_sbo_eligible<std::decay_t<F>>))
     {
+#if defined VX_FUNC_SBO_ADVISOR
         using function_type = std::decay_t<F>;
+        sbo_advisor::record<cfg>(sizeof(function_type),
+            alignof(function_type) <= cfg.alignment && cfg.alignment % alignof(function_type) == 0 &&
+            (!cfg.require_nothrow_movable || std::is_nothrow_move_constructible_v<function_type>) &&
+            (!cfg.trivial_abi || std::is_trivially_copyable_v<function_type>));
+#endif
+        emplace(std::forward<F>(callable));
+    }
 
-        if constexpr (cfg.require_nothrow_invocable) {
-            static_assert(noexcept(std::invoke(callable, std::declval<Args>()...)),
-                "Noexcept callable expected");
+    /// Converting move from another signature/configuration (with cfg.allow_signature_adaptation):
+    /// keeps the Source's storage and actions and installs an adapter invoker converting
+    /// the arguments and the return value around the Source's invoker. 
+    template <cfg::function cfg2, typename R2, typename... Args2>
+    func_base(func_base<cfg2, R2, Args2...> && other) requires (adaptable_from<cfg2, R2, Args2...>) {
+        using source = func_base<cfg2, R2, Args2...>;
+        if (other.call == nullptr) {
+            if constexpr (cfg2.can_be_empty && !cfg.can_be_empty) {
+                throw bad_function_operation{"move constructing from an empty function but this function cannot be empty!"};
+            }
+            call = nullptr;
+            actions = noop_actions;
+            return;
         }
-
-        static_assert(cfg.copyable ? std::is_copy_constructible_v<F> : true, 
-        "The callable has to be copyable");
-
-        static_assert(cfg.movable ? std::is_move_constructible_v<F> : true, 
-        "The callable has to be movable");
-        
-        if constexpr (is_sbo_eligible<function_type>) { /// SBO case
-            new(&data.sbo) function_type(std::forward<F>(callable)); ///< [sbo] created in-place in SBO buffer
-        } else { /// dynamic memory allocation case
-            static_assert(cfg.allow_heap, 
-                "The callable doesn't fit into the SBO buffer [Heap allocation disallowed by the configuration]");
-            
-            data.ptr = new function_type{std::forward<F>(callable)}; ///< [ptr] allocated on the heap
+        if constexpr (cfg2.optimize_for_func_ptrs) {
+            if (other.actions == nullptr) { ///< plain function pointer: store it as a callable
+                using fptr = R2 (*)(Args2...) noexcept(cfg2.require_nothrow_invocable);
+                emplace(reinterpret_cast<fptr>(std::exchange(other.call, nullptr)));
+                other.actions = source::noop_actions;
+                return;
+            }
         }
-
+        other.move_into(data);
+        adapted = reinterpret_cast<void (*)()>(std::exchange(other.call, nullptr));
+        actions = std::exchange(other.actions, source::noop_actions);
         if constexpr (cfg.optimize_for_func_ptrs) {
-            call = reinterpret_cast<void(*)()>(caller_for<F>);
+            call = reinterpret_cast<void (*)()>(adapter_for<source>);
         } else {
-            call = caller_for<F>;
-        }
-
-        /// In-place function case
-        if constexpr (not has_multiple_actions) {
-            actions = dtor_action<function_type>;
-        } else { /// movable and optionally copyable too
-            actions = multiple_actions<function_type>;
+            call = adapter_for<source>;
         }
     }
 
     func_base(R (*fptr) (Args...)) requires(cfg.optimize_for_func_ptrs)
-    : call{ static_cast<void (*)()>(fptr) }
+    : call{ reinterpret_cast<void (*)()>(fptr) }
+    , actions{ nullptr }
+    {}
+
+    /// nontype<fn>: fn is baked into a plain R(*)(Args...) thunk, no storage and no actions
+    template <auto fn>
+    func_base(nontype_t<fn>) noexcept requires(cfg.optimize_for_func_ptrs && returns_r<decltype(fn)>)
+    : call{ reinterpret_cast<void (*)()>(+[](Args... args) noexcept(cfg.require_nothrow_invocable) -> R {
+        if constexpr (std::is_void_v<R>) {
+            std::invoke(fn, std::forward<Args>(args)...);
+        } else {
+            return std::invoke(fn, std::forward<Args>(args)...);
+        }
+    }) }
     , actions{ nullptr }
+    {
+        if constexpr (cfg.require_nothrow_invocable) {
+            static_assert(std::is_nothrow_invocable_v<decltype(fn), Args...>, "Noexcept callable expected");
+        }
+    }
+
+    /// nontype<fn> with a bound first argument: only the argument is stored
+    template <auto fn, typename T>
+    func_base(nontype_t<fn>, T && bound) requires(std::is_invocable_v<bound_nontype<fn, std::decay_t<T>>&, Args...>)
+    : func_base(bound_nontype<fn, std::decay_t<T>>{ std::forward<T>(bound) })
     {}
 
     // template <configuration::function cfg2>
@@ -381,6 +958,7 @@ public:
     requires (cfg.movable)
     {
         other.move_into(data);
+        adapted = other.adapted;
         call = std::exchange(other.call, nullptr);
         actions = std::exchange(other.actions, noop_actions);
     }
@@ -392,6 +970,7 @@ public:
     {
         reset();
         other.move_into(data);
+        adapted = other.adapted;
         call = std::exchange(other.call, nullptr);
         actions = std::exchange(other.actions, noop_actions);
         return *this;
@@ -402,6 +981,7 @@ public:
     func_base(func_base const& other) requires (cfg.copyable) 
     : call{other.call}
     , actions{other.actions} 
+    , adapted{other.adapted}
     {
         other.copy_into(data);
     }
@@ -412,6 +992,7 @@ public:
         other.copy_into(data);
         call = other.call;
         actions = other.actions;
+        adapted = other.adapted;
         return *this;
     }
 
@@ -426,21 +1007,27 @@ public:
         // other.move_into(data);
         // actions(dispatch_tag::Move, tmp, &other.data);
 
-        memory tmp;
-        other.move_into(tmp);
-        this->move_into(other.data);
-        if constexpr (cfg.optimize_for_func_ptrs) {
-            if (actions) { actions(dispatch_tag::Move, tmp, std::addressof(data)); }
+        if constexpr (cfg.trivial_abi) {
+            std::swap(data, other.data);
         } else {
-            actions(dispatch_tag::Move, tmp, std::addressof(data));
+            memory tmp;
+            other.move_into(tmp);
+            this->move_into(other.data);
+            if constexpr (cfg.optimize_for_func_ptrs) {
+                if (actions) { actions(dispatch_tag::Move, tmp, std::addressof(data)); }
+            } else {
+                actions(dispatch_tag::Move, tmp, std::addressof(data));
+            }
         }
 
         std::swap(call, other.call);
         std::swap(actions, other.actions);
+        std::swap(adapted, other.adapted);
     }
 
 
-    R operator() (Args... args) noexcept(cfg.require_nothrow_invocable && !cfg.check_empty) {
+    R operator() (Args... args) noexcept(cfg.require_nothrow_invocable && !cfg.check_empty)
+    requires (not cfg.require_rvalue_invocable) {
         if constexpr (cfg.check_empty) {
             if (call == nullptr) { throw bad_function_call{}; }
         }
@@ -512,7 +1099,7 @@ public:
     
 
     ~func_base() {
-        if constexpr (cfg.optimize_for_func_ptrs) {
+        if constexpr (cfg.optimize_for_func_ptrs || cfg.require_rvalue_invocable) {
             if (actions == nullptr) { return; }
         }
         if constexpr (not has_multiple_actions) {
@@ -524,6 +1111,31 @@ public:
     }
 
 protected:
+    /// One-shot call: the callable is invoked as an rvalue and destroyed by the same invoker,
+    /// leaving the function empty (as if moved-from) even if the call throws.
+    R invoke_once(Args... args) noexcept(cfg.require_nothrow_invocable && !cfg.check_empty)
+    requires (cfg.require_rvalue_invocable) {
+        if constexpr (cfg.check_empty) {
+            if (call == nullptr) { throw bad_function_call{}; }
+        }
+        auto invoker = std::exchange(call, nullptr);
+        if constexpr (cfg.optimize_for_func_ptrs) {
+            if (actions == nullptr) {
+                return reinterpret_cast<R (*) (Args...)>(invoker)(std::forward<Args>(args)...);
+            }
+        }
+        if constexpr (has_multiple_actions) {
+            actions = noop_actions;
+        } else {
+            actions = nullptr;
+        }
+        if constexpr (cfg.optimize_for_func_ptrs) {
+            return reinterpret_cast<invoker_type>(invoker)(data, std::forward<Args>(args)...);
+        } else {
+            return invoker(data, std::forward<Args>(args)...);
+        }
+    }
+
     void reset() { 
         if constexpr (cfg.optimize_for_func_ptrs) {
             if (actions == nullptr) { 
@@ -548,6 +1160,10 @@ protected:
     }
 
     void move_into(memory& mem) {
+        if constexpr (cfg.trivial_abi) { ///< bitwise relocation
+            mem = data;
+            return;
+        }
         if constexpr (cfg.optimize_for_func_ptrs) {
             if (!actions) { return; }
         }
@@ -561,36 +1177,305 @@ protected:
         actions(dispatch_tag::Copy, const_cast<memory&>(data), std::addressof(mem));
     }
 
+    template <typename F>
+    void emplace(F && callable) {
+        using function_type = std::decay_t<F>;
+
+        if constexpr (cfg.require_nothrow_invocable) {
+            static_assert(noexcept(std::invoke(callable, std::declval<Args>()...)),
+                "Noexcept callable expected");
+        }
+
+        static_assert(cfg.copyable ? std::is_copy_constructible_v<F> : true, 
+        "The callable has to be copyable");
+
+        static_assert(cfg.movable ? std::is_move_constructible_v<F> : true, 
+        "The callable has to be movable");
+        
+        if constexpr (is_sbo_eligible<function_type>) { /// SBO case
+            new(&data.sbo) function_type(std::forward<F>(callable)); ///< [sbo] created in-place in SBO buffer
+        } else { /// dynamic memory allocation case
+            static_assert(cfg.allow_heap, 
+                "The callable doesn't fit into the SBO buffer [Heap allocation disallowed by the configuration]");
+            
+            on_heap_allocation<function_type>();
+            data.ptr = new function_type{std::forward<F>(callable)}; ///< [ptr] allocated on the heap
+        }
+
+        if constexpr (cfg.optimize_for_func_ptrs) {
+            call = reinterpret_cast<void(*)()>(caller_for<function_type>);
+        } else {
+            call = caller_for<function_type>;
+        }
+
+        /// In-place function case
+        if constexpr (not has_multiple_actions) {
+            actions = dtor_action<function_type>;
+        } else { /// movable and optionally copyable too
+            actions = multiple_actions<function_type>;
+        }
+    }
+
 private:
     memory data;
     invoke_f call = nullptr;
     action_f actions = nullptr;
+    using adapted_f = std::conditional_t<cfg.allow_signature_adaptation, void (*)(), empty_slot>;
+#ifdef _MSC_VER
+    [[msvc::no_unique_address]] adapted_f adapted {}; ///< Source's invoker, see adapter_for
+    [[msvc::no_unique_address]] abi_guard<cfg.trivial_abi> abi;
+#else 
+    [[no_unique_address]] adapted_f adapted {}; ///< Source's invoker, see adapter_for
+    [[no_unique_address]] abi_guard<cfg.trivial_abi> abi;
+#endif
+};
+
+#if defined __clang__
+    #pragma clang diagnostic pop
+#endif
+
+
+/// Trivially copyable func, used for cfg.trivial_abi configurations that never need management actions
+/// (no heap, no typeinfo): holds just the SBO and the invoker, so every compiler passes it in registers
+/// when it is small enough (e.g. .SBO = 8 with .alignment = 8 gives 16 bytes).
+/// Function pointers are stored in the SBO like any other callable; moved-from objects stay valid.
+template <cfg::function cfg, typename R, typename... Args>
+class trivial_func_base {
+public:
+    template <typename F>
+    static constexpr bool is_sbo_eligible = sizeof(F) <= cfg.SBO && ///< fits into SBO buffer
+                                     alignof(F) <= cfg.alignment && ///< and has lower alignment
+                                     (cfg.alignment % alignof(F) == 0) && 
+                                     std::is_trivially_copyable_v<F>;
+
+    template <typename F>
+    static constexpr bool returns_r = func_base<cfg, R, Args...>::template returns_r<F>;
+
+private:
+    static constexpr auto bufsize = std::max(cfg.SBO, std::size_t{1});
+    using memory = memory_SBO<bufsize, cfg.alignment>;
+
+    template <typename F>
+    using const_correct = std::conditional_t<(cfg.require_const_invocable), std::add_const_t<F>, F>;
+
+    using invoker_type = R (*)(const_correct<memory> &, Args...) noexcept(cfg.require_nothrow_invocable);
+
+    template <typename F>
+    VX_HOT static R invoke_stored(const_correct<memory>& mem, Args... args) noexcept(cfg.require_nothrow_invocable) {
+#if defined VX_FUNC_TRACE
+        trace::record<F, Args...>(&mem);
+#endif
+        [[maybe_unused]] std::conditional_t<cfg.trace_invocations, flight_recorder::scope<F>, empty_slot> recorded;
+        auto& f = mem.template as_sbo<F>();
+        if constexpr (cfg.allow_return_type_conversion) {
+            if constexpr (!std::is_void_v<R>) { 
+                return R( f(args...) ); 
+            } else {
+                f(args...);
+            }
+        } else {
+            return f(args...);
+        }
+    }
+
+    template <typename F>
+    static constexpr invoker_type caller_for = &invoke_stored<F>;
+
+public:
+    trivial_func_base() noexcept requires (cfg.can_be_empty) = default;
+
+    trivial_func_base(std::nullptr_t) noexcept requires (cfg.can_be_empty) {}
+
+    template <std::invocable<Args...> F>
+    trivial_func_base (F && callable) requires (
+        !std::derived_from<std::remove_cvref_t<F>, trivial_func_base> && returns_r<std::decay_t<F>&> && is_sbo_eligible<std::decay_t<F>>)
+    : call{ caller_for<std::decay_t<F>> }
+    {
+        if constexpr (cfg.require_nothrow_invocable) {
+            static_assert(noexcept(std::invoke(callable, std::declval<Args>()...)),
+                "Noexcept callable expected");
+        }
+        new(&data.sbo) std::decay_t<F>(std::forward<F>(callable));
+    }
+
+    /// nontype<fn> with a bound first argument: only the argument is stored
+    template <auto fn, typename T>
+    trivial_func_base(nontype_t<fn>, T && bound) requires(std::is_invocable_v<bound_nontype<fn, std::decay_t<T>>&, Args...>)
+    : trivial_func_base(bound_nontype<fn, std::decay_t<T>>{ std::forward<T>(bound) })
+    {}
+
+    trivial_func_base(trivial_func_base const&) requires (cfg.copyable) = default;
+    trivial_func_base(trivial_func_base &&) requires (cfg.movable) = default;
+    trivial_func_base& operator= (trivial_func_base const&) requires (cfg.copyable) = default;
+    trivial_func_base& operator= (trivial_func_base &&) requires (cfg.movable) = default;
+    ~trivial_func_base() = default;
+
+    void swap(trivial_func_base & other) noexcept requires(cfg.movable) {
+        std::swap(*this, other);
+    }
+
+    R operator() (Args... args) noexcept(cfg.require_nothrow_invocable && !cfg.check_empty) {
+        if constexpr (cfg.check_empty) {
+            if (call == nullptr) { throw bad_function_call{}; }
+        }
+        return call(data, std::forward<Args>(args)...);
+    }
+
+    /// If function's signature contains `const` 
+    R operator() (Args... args) const noexcept(cfg.require_nothrow_invocable && !cfg.check_empty) 
+    requires (cfg.require_const_invocable) {
+        if constexpr (cfg.check_empty) {
+            if (call == nullptr) { throw bad_function_call{}; }
+        }
+        return call(data, std::forward<Args>(args)...);
+    }
+
+    operator bool() const noexcept {
+        return call != nullptr; 
+    }
+
+private:
+    memory data {};
+    invoker_type call = nullptr;
 };
 
+/// trivial_func_base where it can be trivially copyable (see cfg::func::trivial_abi for the differences)
+template <cfg::function cfg, typename R, typename... Args>
+using func_base_for = std::conditional_t<(cfg.trivial_abi && !cfg.allow_heap && !cfg.enable_typeinfo), 
+    trivial_func_base<cfg, R, Args...>, 
+    func_base<cfg, R, Args...>>;
+
 } // namespace detail
 
 
-template <typename Signature, cfg::function cfg = cfg::function{}>
+template <typename Signature, cfg::function cfg = cfg::function{}, typename... Interceptors>
 class func;
 
 template <typename R, typename... Args, cfg::function cfg>
-class func<R(Args...), cfg> : public detail::func_base<cfg, R, Args...> {
-    using detail::func_base<cfg, R, Args...>::func_base;
+class func<R(Args...), cfg> : public detail::func_base_for<cfg, R, Args...> {
+    using base = detail::func_base_for<cfg, R, Args...>;
+    using base::base;
+};
+
+template <typename R, typename... Args, cfg::function cfg>
+class func<R(Args...) const, cfg> : public detail::func_base_for<cfg.with_const_invocable(true), R, Args...> {
+    using base = detail::func_base_for<cfg.with_const_invocable(true), R, Args...>;
+    using base::base;
+};
+
+template <typename R, typename... Args, cfg::function cfg>
+class func<R(Args...) noexcept, cfg> : public detail::func_base_for<cfg.with_nothrow_invocable(true), R, Args...> {
+    using base = detail::func_base_for<cfg.with_nothrow_invocable(true), R, Args...>;
+    using base::base;
 };
 
 template <typename R, typename... Args, cfg::function cfg>
-class func<R(Args...) const, cfg> : public detail::func_base<cfg.with_const_invocable(true), R, Args...> {
-    using detail::func_base<cfg.with_const_invocable(true), R, Args...>::func_base;
+class func<R(Args...) const noexcept, cfg> : public detail::func_base_for<cfg.with_const_invocable(true).with_nothrow_invocable(true), R, Args...> {
+    using base = detail::func_base_for<cfg.with_const_invocable(true).with_nothrow_invocable(true), R, Args...>;
+    using base::base;
 };
 
+/// One-shot function: `std::move(f)(args...)` invokes the callable as an rvalue and destroys it
 template <typename R, typename... Args, cfg::function cfg>
-class func<R(Args...) noexcept, cfg> : public detail::func_base<cfg.with_nothrow_invocable(true), R, Args...> {
-    using detail::func_base<cfg.with_nothrow_invocable(true), R, Args...>::func_base;
+class func<R(Args...) &&, cfg> : public detail::func_base<cfg.with_rvalue_invocable(true), R, Args...> {
+    using base = detail::func_base<cfg.with_rvalue_invocable(true), R, Args...>;
+public:
+    using base::base;
+
+    R operator() (Args... args) && noexcept(cfg.require_nothrow_invocable && !cfg.check_empty) {
+        return this->invoke_once(std::forward<Args>(args)...);
+    }
 };
 
 template <typename R, typename... Args, cfg::function cfg>
-class func<R(Args...) const noexcept, cfg> : public detail::func_base<cfg.with_const_invocable(true).with_nothrow_invocable(true), R, Args...> {
-    using detail::func_base<cfg.with_const_invocable(true).with_nothrow_invocable(true), R, Args...>::func_base;
+class func<R(Args...) && noexcept, cfg> : public detail::func_base<cfg.with_rvalue_invocable(true).with_nothrow_invocable(true), R, Args...> {
+    using base = detail::func_base<cfg.with_rvalue_invocable(true).with_nothrow_invocable(true), R, Args...>;
+public:
+    using base::base;
+
+    R operator() (Args... args) && noexcept(!cfg.check_empty) {
+        return this->invoke_once(std::forward<Args>(args)...);
+    }
+};
+
+/// Invocation middleware fused at compile time: every stored callable is wrapped with the stateless Interceptors,
+/// whose hooks are inlined into its invoker (no extra storage, no extra indirect call). An interceptor provides
+/// either `static decltype(auto) around(auto&& next, Args&&... args)` or any of `static void before(Args const&...)`
+/// and `static void after()` (also run when the call throws); the first interceptor is the outermost.
+///
+///     struct count_calls { static void before(auto const&...) { ++calls; } };
+///     vx::func<int(int), vx::cfg::function{}, count_calls, timing> f = [](int x) { return x + 1; };
+///
+/// Exceptions from hooks propagate like those of the callable; with a noexcept signature the hooks have to be
+/// declared noexcept. Plain function pointers and nontype<fn> are wrapped as well. The intercepted func holds
+/// (rather than derives from) a func<Signature, cfg>, so it cannot be sliced into one without its interceptors.
+template <typename Signature, cfg::function cfg, typename Interceptor, typename... Interceptors>
+class func<Signature, cfg, Interceptor, Interceptors...> {
+    using inner_type = func<Signature, cfg>;
+
+    template <typename F>
+    using wrapped = detail::intercepted<std::decay_t<F>, Interceptor, Interceptors...>;
+
+public:
+    template <typename F>
+    static constexpr bool is_sbo_eligible = inner_type::template is_sbo_eligible<wrapped<F>>;
+
+    func() noexcept requires std::default_initializable<inner_type>
+    : inner{}
+    {}
+
+    func(std::nullptr_t) noexcept requires std::constructible_from<inner_type, std::nullptr_t>
+    : inner{ nullptr }
+    {}
+
+    template <typename F>
+    func(F && callable) requires (
+        !std::same_as<std::remove_cvref_t<F>, func> && !std::same_as<std::remove_cvref_t<F>, std::nullptr_t> &&
+        std::constructible_from<inner_type, wrapped<F>>)
+    : inner{ wrapped<F>{ std::forward<F>(callable) } }
+    {}
+
+    template <auto fn, typename T>
+    func(nontype_t<fn>, T && bound) requires std::constructible_from<inner_type, wrapped<detail::bound_nontype<fn, std::decay_t<T>>>>
+    : inner{ wrapped<detail::bound_nontype<fn, std::decay_t<T>>>{ { std::forward<T>(bound) } } }
+    {}
+
+    template <typename... Args> requires std::invocable<inner_type&, Args...>
+    decltype(auto) operator() (Args&&... args) noexcept(std::is_nothrow_invocable_v<inner_type&, Args...>) {
+        return inner(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> requires std::invocable<inner_type const&, Args...>
+    decltype(auto) operator() (Args&&... args) const noexcept(std::is_nothrow_invocable_v<inner_type const&, Args...>) {
+        return inner(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> requires std::invocable<inner_type&&, Args...>
+    decltype(auto) operator() (Args&&... args) && noexcept(std::is_nothrow_invocable_v<inner_type&&, Args...>) {
+        return std::move(inner)(std::forward<Args>(args)...);
+    }
+
+    explicit(false) operator bool() const noexcept { return static_cast<bool>(inner); }
+
+    void swap(func & other) noexcept requires std::swappable<inner_type> { inner.swap(other.inner); }
+
+    const std::type_info& target_type() const noexcept requires (cfg.enable_typeinfo) { return inner.target_type(); }
+
+    /// The stored callable (without the interceptor wrapper), or nullptr
+    template <typename F>
+    F* target() noexcept requires (cfg.enable_typeinfo) {
+        auto * w = inner.template target<wrapped<F>>();
+        return w != nullptr ? &w->callable : nullptr;
+    }
+
+    template <typename F>
+    const F* target() const noexcept requires (cfg.enable_typeinfo) {
+        auto const* w = inner.template target<wrapped<F>>();
+        return w != nullptr ? &w->callable : nullptr;
+    }
+
+private:
+    inner_type inner;
 };
 
 
@@ -608,6 +1493,290 @@ using move_only_func = vx::func<Signature, vx::cfg::func{
             .copyable=false,
             .movable=true }>;
 
+
+namespace detail {
+
+/// Index of T in Ts..., or sizeof...(Ts) if T is not in the pack
+template <typename T, typename... Ts>
+constexpr std::size_t index_in_pack = [] {
+    std::size_t i = 0;
+    ((std::is_same_v<T, Ts> ? false : (++i, true)) && ...);
+    return i;
+}();
+
+/// Calls visitor(std::integral_constant<std::size_t, index>{}) through a `switch`, 
+/// so that the compiler can build a jump table and inline every alternative.
+/// Cases are stamped 8 at a time, larger packs recurse into the next block.
+template <std::size_t N, std::size_t Base = 0, typename Visitor>
+constexpr decltype(auto) visit_index(std::size_t index, Visitor&& visitor) {
+#define VX_VISIT_CASE(n) \
+    case Base + n: { \
+        if constexpr (Base + n < N) { return visitor(std::integral_constant<std::size_t, Base + n>{}); } \
+        else { VX_UNREACHABLE(); } \
+    } [[fallthrough]];
+
+    switch (index) {
+        VX_VISIT_CASE(0) VX_VISIT_CASE(1) VX_VISIT_CASE(2) VX_VISIT_CASE(3)
+        VX_VISIT_CASE(4) VX_VISIT_CASE(5) VX_VISIT_CASE(6) VX_VISIT_CASE(7)
+        default: {
+            if constexpr (Base + 8 < N) { return visit_index<N, Base + 8>(index, std::forward<Visitor>(visitor)); }
+            else { VX_UNREACHABLE(); }
+        }
+    }
+#undef VX_VISIT_CASE
+}
+
+
+/// Closed-set function: stores one of Fs... inline plus a small index and dispatches with a `switch`
+/// instead of an indirect call. SBO, alignment and allow_heap knobs are ignored: 
+/// the storage is always sized and aligned for the largest alternative.
+template <cfg::function cfg, typename Signature, typename... Fs>
+class func_variant_base;
+
+template <cfg::function cfg, typename R, typename... Args, typename... Fs>
+class func_variant_base<cfg, R(Args...), Fs...> {
+    static_assert(sizeof...(Fs) > 0, "func_variant needs at least one alternative");
+    static_assert(((std::is_same_v<Fs, std::decay_t<Fs>>) && ...), "Alternatives have to be decayed (non-reference, non-cv) types");
+
+    static constexpr std::size_t alternatives = sizeof...(Fs);
+    static constexpr std::size_t empty_index = alternatives;
+
+    using index_type = std::conditional_t<(alternatives < 255), std::uint8_t, std::uint16_t>;
+
+    template <std::size_t I>
+    using alternative = std::tuple_element_t<I, std::tuple<Fs...>>;
+
+    template <typename F>
+    using const_correct = std::conditional_t<(cfg.require_const_invocable), std::add_const_t<F>, F>;
+
+    static_assert((std::is_invocable_v<const_correct<Fs>&, Args...> && ...), 
+        "All alternatives have to be invocable with the signature's arguments");
+
+    static_assert(!cfg.require_nothrow_invocable || (std::is_nothrow_invocable_v<const_correct<Fs>&, Args...> && ...), 
+        "Noexcept callable expected");
+
+    static_assert(!cfg.copyable || (std::is_copy_constructible_v<Fs> && ...), 
+        "The callable has to be copyable");
+
+    static_assert(!cfg.movable || (std::is_move_constructible_v<Fs> && ...), 
+        "The callable has to be movable");
+
+    static_assert(!cfg.movable || !cfg.require_nothrow_movable || (std::is_nothrow_move_constructible_v<Fs> && ...), 
+        "The callable has to be nothrow movable");
+
+public:
+    template <typename F>
+    static constexpr bool is_alternative = index_in_pack<std::decay_t<F>, Fs...> < alternatives;
+
+    func_variant_base() noexcept requires (cfg.can_be_empty) 
+    : index_{empty_index} 
+    {}
+
+    func_variant_base(std::nullptr_t) noexcept requires (cfg.can_be_empty) 
+    : index_{empty_index} 
+    {}
+
+    template <typename F>
+    func_variant_base (F && callable) requires (is_alternative<F>)
+    : index_{ index_in_pack<std::decay_t<F>, Fs...> }
+    {
+        new(&storage) std::decay_t<F>(std::forward<F>(callable));
+    }
+
+    /// MOVE (if movable == true)
+    func_variant_base(func_variant_base&& other) noexcept(cfg.require_nothrow_movable) 
+    requires (cfg.movable) 
+    {
+        other.move_into(*this);
+    }
+
+    func_variant_base& operator= (func_variant_base&& other) noexcept(cfg.require_nothrow_movable) 
+    requires (cfg.movable) 
+    {
+        if (&other == this) { return *this; }
+        reset();
+        other.move_into(*this);
+        return *this;
+    }
+
+    /// COPY (if copyable == true)
+    func_variant_base(func_variant_base const& other) 
+    requires (cfg.copyable) 
+    {
+        other.copy_into(*this);
+    }
+
+    func_variant_base& operator= (func_variant_base const& other) 
+    requires (cfg.copyable) 
+    {
+        if (&other == this) { return *this; }
+        reset();
+        other.copy_into(*this);
+        return *this;
+    }
+
+    void swap(func_variant_base & other) noexcept(cfg.require_nothrow_movable) requires(cfg.movable) {
+        if (&other == this) { return; }
+        func_variant_base tmp = std::move(other);
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    R operator() (Args... args) noexcept(cfg.require_nothrow_invocable && !cfg.check_empty) {
+        return dispatch(*this, std::forward<Args>(args)...);
+    }
+
+    /// If function's signature contains `const` 
+    R operator() (Args... args) const noexcept(cfg.require_nothrow_invocable && !cfg.check_empty) 
+    requires (cfg.require_const_invocable) {
+        return dispatch(*this, std::forward<Args>(args)...);
+    }
+
+    /// Index of the stored alternative, sizeof...(Fs) if empty
+    std::size_t index() const noexcept {
+        return index_;
+    }
+
+    const std::type_info& target_type() const noexcept 
+    requires(cfg.enable_typeinfo) {
+        if (index_ == empty_index) { return typeid(void); }
+        return visit_index<alternatives>(index_, [](auto i) -> const std::type_info& { 
+            return typeid(alternative<i>); 
+        });
+    }
+
+    template <typename F>
+    F* target() noexcept 
+    requires(cfg.enable_typeinfo) {
+        constexpr auto I = index_in_pack<F, Fs...>;
+        if constexpr (I == alternatives) { return nullptr; }
+        else { return index_ == I ? std::addressof(get<I>()) : nullptr; }
+    }
+
+    template <typename F>
+    const F* target() const noexcept 
+    requires(cfg.enable_typeinfo) {
+        constexpr auto I = index_in_pack<F, Fs...>;
+        if constexpr (I == alternatives) { return nullptr; }
+        else { return index_ == I ? std::addressof(get<I>()) : nullptr; }
+    }
+
+    operator bool() const noexcept {
+        return index_ != empty_index;
+    }
+
+    ~func_variant_base() {
+        reset();
+    }
+
+private:
+    template <std::size_t I>
+    alternative<I>& get() noexcept {
+        return *std::launder(reinterpret_cast<alternative<I>*>(&storage));
+    }
+
+    template <std::size_t I>
+    alternative<I> const& get() const noexcept {
+        return *std::launder(reinterpret_cast<alternative<I> const*>(&storage));
+    }
+
+    template <typename Self>
+    static R dispatch(Self& self, Args&&... args) {
+        if constexpr (cfg.check_empty) {
+            if (self.index_ == empty_index) { throw bad_function_call{}; }
+        }
+        return visit_index<alternatives>(self.index_, [&](auto i) -> R {
+            const_correct<Self>& f_owner = self;
+            auto& f = f_owner.template get<i>();
+            if constexpr (cfg.allow_return_type_conversion) {
+                if constexpr (!std::is_void_v<R>) { 
+                    return R( f(std::forward<Args>(args)...) ); 
+                } else {
+                    f(std::forward<Args>(args)...);
+                }
+            } else {
+                return f(std::forward<Args>(args)...);
+            }
+        });
+    }
+
+    void reset() noexcept {
+        if (index_ == empty_index) { return; }
+        visit_index<alternatives>(index_, [this](auto i) {
+            std::destroy_at(std::addressof(get<i>()));
+        });
+        index_ = empty_index;
+    }
+
+    void move_into(func_variant_base& dest) noexcept(cfg.require_nothrow_movable) {
+        dest.index_ = empty_index;
+        if (index_ == empty_index) { return; }
+        visit_index<alternatives>(index_, [&](auto i) {
+            new(&dest.storage) alternative<i>(std::move(get<i>()));
+        });
+        dest.index_ = index_;
+        reset(); ///< moved-from is empty, as with func
+    }
+
+    void copy_into(func_variant_base& dest) const {
+        dest.index_ = empty_index;
+        if (index_ == empty_index) { return; }
+        visit_index<alternatives>(index_, [&](auto i) {
+            new(&dest.storage) alternative<i>(get<i>());
+        });
+        dest.index_ = index_;
+    }
+
+    alignas(Fs...) std::byte storage [std::max({sizeof(Fs)...})];
+    index_type index_;
+};
+
+} // namespace detail
+
+
+template <typename Signature, cfg::function cfg, typename... Fs>
+class basic_func_variant;
+
+template <typename R, typename... Args, cfg::function cfg, typename... Fs>
+class basic_func_variant<R(Args...), cfg, Fs...> : public detail::func_variant_base<cfg, R(Args...), Fs...> {
+    using detail::func_variant_base<cfg, R(Args...), Fs...>::func_variant_base;
+};
+
+template <typename R, typename... Args, cfg::function cfg, typename... Fs>
+class basic_func_variant<R(Args...) const, cfg, Fs...> : public detail::func_variant_base<cfg.with_const_invocable(true), R(Args...), Fs...> {
+    using detail::func_variant_base<cfg.with_const_invocable(true), R(Args...), Fs...>::func_variant_base;
+};
+
+template <typename R, typename... Args, cfg::function cfg, typename... Fs>
+class basic_func_variant<R(Args...) noexcept, cfg, Fs...> : public detail::func_variant_base<cfg.with_nothrow_invocable(true), R(Args...), Fs...> {
+    using detail::func_variant_base<cfg.with_nothrow_invocable(true), R(Args...), Fs...>::func_variant_base;
+};
+
+template <typename R, typename... Args, cfg::function cfg, typename... Fs>
+class basic_func_variant<R(Args...) const noexcept, cfg, Fs...> : public detail::func_variant_base<cfg.with_const_invocable(true).with_nothrow_invocable(true), R(Args...), Fs...> {
+    using detail::func_variant_base<cfg.with_const_invocable(true).with_nothrow_invocable(true), R(Args...), Fs...>::func_variant_base;
+};
+
+/// @brief Closed-set alternative to func: vx::func_variant<int(int), A, B, C> f = B{};
+/// @tparam Signature - same as for func (const/noexcept supported)
+/// @tparam Fs - all the callable types it may hold
+template <typename Signature, typename... Fs>
+using func_variant = basic_func_variant<Signature, cfg::function{}, Fs...>;
+
 } // namespace vx
 
+/// Explicit instantiation of the func_base behind vx::func<R(Args...), cfg> to compile it once per binary:
+/// VX_FUNC_EXTERN_TEMPLATE(cfg, R, Args...); in a shared header suppresses the implicit instantiation in every TU,
+/// VX_FUNC_INSTANTIATE(cfg, R, Args...); in exactly one TU provides it. cfg has to be free of top-level commas
+/// (a named constant); for const/noexcept signatures pass cfg.with_const_invocable(true)/.with_nothrow_invocable(true)
+#define VX_FUNC_EXTERN_TEMPLATE(cfg, ...) \
+    static_assert(std::is_same_v<vx::detail::func_base_for<cfg, __VA_ARGS__>, vx::detail::func_base<cfg, __VA_ARGS__>>, \
+        "trivially copyable configurations are header-only"); \
+    extern template class vx::detail::func_base<cfg, __VA_ARGS__>
+
+#define VX_FUNC_INSTANTIATE(cfg, ...) template class vx::detail::func_base<cfg, __VA_ARGS__>
+
 #undef VX_UNREACHABLE
+#undef VX_TRIVIAL_ABI
+#undef VX_HOT
+#undef VX_COLD
@@ -0,0 +1,146 @@
+#pragma once
+
+/// Handler registry with O(1) insert/erase, stable generational handles and dense storage:
+///
+///     vx::func_slot_map<void(event const&)> handlers;
+///     auto h = handlers.insert([&](event const& e) { ... });
+///     handlers.for_each_invoke(e);   ///< sequential walk over the funcs, no hashing or node chasing
+///     handlers.erase(h);             ///< the last func is moved into the hole (swap-and-pop)
+///
+/// The funcs live contiguously in insertion order modulo removals; a handle is a slot index plus the slot's
+/// generation, so handles of erased entries are detected (and never alias a later entry) instead of dangling.
+/// Pointers and references to stored funcs are invalidated by insert and erase, handles are not.
+
+#include <cstdint> // std::uint32_t
+#include <utility>
+#include <vector>
+#include "func.hpp"
+
+namespace vx {
+
+template <typename Signature, cfg::function cfg = cfg::function{}>
+class func_slot_map {
+public:
+    using value_type = func<Signature, cfg>;
+    using size_type = std::uint32_t;
+
+    static_assert(cfg.movable, "func_slot_map relocates funcs on erase and growth: cfg.movable is required");
+
+    /// Slot index and generation (never 0 for a live slot, so a default constructed handle is always stale)
+    struct handle {
+        size_type index = 0;
+        size_type generation = 0;
+
+        friend bool operator== (handle, handle) = default;
+    };
+
+    template <typename F>
+    handle insert(F && callable) {
+        if (free_head == npos && slots.size() == npos) { throw bad_function_operation{"func_slot_map is full"}; }
+        dense.emplace_back(std::forward<F>(callable));
+        try {
+            owners.push_back(free_head != npos ? free_head : static_cast<size_type>(slots.size()));
+            if (free_head == npos) { slots.push_back({ npos, 1 }); }
+        } catch (...) {
+            owners.resize(dense.size() - 1);
+            dense.pop_back();
+            throw;
+        }
+        const auto index = owners.back();
+        if (index == free_head) { free_head = slots[index].position; }
+        slots[index].position = static_cast<size_type>(dense.size() - 1);
+        return { index, slots[index].generation };
+    }
+
+    /// Removes the entry of h (moving the last func into its place); false if h is stale
+    bool erase(handle h) {
+        if (!contains(h)) { return false; }
+        const auto position = slots[h.index].position;
+        const auto last = static_cast<size_type>(dense.size() - 1);
+        if (position != last) {
+            dense[position] = std::move(dense[last]);
+            owners[position] = owners[last];
+            slots[owners[position]].position = position;
+        }
+        dense.pop_back();
+        owners.pop_back();
+
+        release(h.index);
+        return true;
+    }
+
+    [[nodiscard]] bool contains(handle h) const noexcept {
+        return h.index < slots.size() && slots[h.index].generation == h.generation;
+    }
+
+    /// The func of h, or nullptr if h is stale
+    [[nodiscard]] value_type * find(handle h) noexcept {
+        return contains(h) ? &dense[slots[h.index].position] : nullptr;
+    }
+
+    [[nodiscard]] value_type const* find(handle h) const noexcept {
+        return contains(h) ? &dense[slots[h.index].position] : nullptr;
+    }
+
+    [[nodiscard]] value_type & at(handle h) {
+        if (!contains(h)) { throw bad_function_operation{"stale func_slot_map handle"}; }
+        return dense[slots[h.index].position];
+    }
+
+    /// Invokes every func in storage order with the same arguments, passed as lvalues (never moved from);
+    /// results are discarded
+    template <typename... Args>
+    void for_each_invoke(Args&&... args) {
+        for (auto& f : dense) { f(args...); }
+    }
+
+    template <typename... Args>
+    void for_each_invoke(Args&&... args) const {
+        for (auto const& f : dense) { f(args...); }
+    }
+
+    void reserve(size_type n) {
+        dense.reserve(n);
+        owners.reserve(n);
+        slots.reserve(n);
+    }
+
+    /// Removes all entries; outstanding handles become stale. Destroys the funcs in place (no moves, cannot throw)
+    void clear() noexcept {
+        for (auto i = owners.size(); i-- > 0;) { release(owners[i]); }
+        dense.clear();
+        owners.clear();
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return static_cast<size_type>(dense.size()); }
+    [[nodiscard]] bool empty() const noexcept { return dense.empty(); }
+
+    /// Dense iteration over the funcs (order changes on erase)
+    auto begin() noexcept { return dense.begin(); }
+    auto end() noexcept { return dense.end(); }
+    auto begin() const noexcept { return dense.begin(); }
+    auto end() const noexcept { return dense.end(); }
+
+private:
+    static constexpr size_type npos = ~size_type{0};
+
+    struct slot {
+        size_type position; ///< index into dense while occupied, next free slot otherwise
+        size_type generation;
+    };
+
+    /// Makes the handles of slot index stale and puts it on the free list
+    void release(size_type index) noexcept {
+        auto& slot = slots[index];
+        slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1; ///< 0 is reserved for default handles
+        slot.position = free_head;
+        free_head = index;
+    }
+
+    std::vector<value_type> dense;
+    std::vector<size_type> owners; ///< slot index of each dense entry
+    std::vector<slot> slots;
+    size_type free_head = npos;
+};
+
+} // namespace vx
@@ -0,0 +1,147 @@
+#pragma once
+
+/// Position-independent vx::func for memory shared between processes (e.g. task queues in a shared ring buffer).
+///
+/// A vx::shared_func stores a registered type ID and the callable inline, with no code or heap pointers,
+/// so it can be placed in (or memcpy'd through) shared memory and invoked by any process running the same
+/// binary that registered the same types under the same IDs:
+///
+///     struct resize_task { std::uint32_t image; std::uint16_t w, h; void operator()(worker&) const; };
+///     vx::shared_registry<void(worker&)>::add<resize_task>(1); // at startup, in every process
+///
+///     vx::shared_func<void(worker&)> task = resize_task{ 42, 640, 480 };
+///     ring.push(task); ... ring.pop()(self);
+///
+/// Invokers are resolved through a per-process table indexed by the ID. Callables have to be trivially copyable
+/// (so there are no actions to resolve: relocation is memcpy and destruction is a no-op) and must not hold pointers
+/// into process-local memory, which cannot be checked here.
+///
+/// Only plain `R(Args...)` signatures are supported (no const, noexcept or ref-qualifiers), and of the cfg only
+/// SBO, alignment and check_empty are used: knobs that would change the behaviour (nothrow/const/rvalue invocation,
+/// typeinfo, tracing, signature adaptation, non-copyable or non-movable) are rejected at compile time.
+
+#include <cstdint> // std::uint32_t
+#include <cstring> // std::memcpy
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "func.hpp"
+
+namespace vx {
+
+namespace detail {
+
+/// Dependent false for static_asserts in primary templates (sizeof of a function type is ill-formed)
+template <typename>
+inline constexpr bool always_false = false;
+
+} // namespace detail
+
+template <typename Signature>
+class shared_registry {
+    static_assert(detail::always_false<Signature>, "shared funcs support plain R(Args...) signatures only (no const, noexcept or ref-qualifiers)");
+};
+
+/// @brief Per-process table mapping type IDs to invokers; register the same types under the same IDs in every process
+template <typename R, typename... Args>
+class shared_registry<R(Args...)> {
+public:
+    using id_type = std::uint32_t;
+    using invoker_type = R (*)(void*, Args&&...);
+
+    static constexpr id_type empty_id = 0; ///< reserved for the empty state
+    static constexpr id_type capacity = 256; ///< valid IDs are 1..capacity-1
+
+    /// Registers F under id; re-registering the same pair is a no-op. Not thread-safe: call before sharing funcs
+    template <typename F>
+    static void add(id_type id) {
+        static_assert(std::is_trivially_copyable_v<F>, "shared funcs hold trivially copyable callables only");
+        static_assert(std::is_invocable_r_v<R, F&, Args...>, "callable does not match the signature");
+
+        if (id == empty_id || id >= capacity) { throw bad_function_operation{"shared func ID out of range"}; }
+        if (type_id<F> == id && table[id] == &invoke<F>) { return; }
+        if (type_id<F> != empty_id || table[id] != nullptr) { throw bad_function_operation{"shared func ID already in use"}; }
+
+        table[id] = &invoke<F>;
+        type_id<F> = id;
+    }
+
+    template <typename F>
+    [[nodiscard]] static id_type id_of() noexcept { return type_id<F>; }
+
+    [[nodiscard]] static invoker_type at(id_type id) noexcept {
+        return id < capacity ? table[id] : nullptr;
+    }
+
+private:
+    template <typename F>
+    static R invoke(void* mem, Args&&... args) {
+        return std::invoke(*std::launder(static_cast<F*>(mem)), std::forward<Args>(args)...);
+    }
+
+    static inline invoker_type table [capacity] {};
+
+    template <typename F>
+    static inline id_type type_id = empty_id;
+};
+
+
+template <typename Signature, cfg::function cfg = cfg::function{}>
+class shared_func {
+    static_assert(detail::always_false<Signature>, "shared funcs support plain R(Args...) signatures only (no const, noexcept or ref-qualifiers)");
+};
+
+/// @brief Trivially copyable func made of a type ID and an inline payload
+template <typename R, typename... Args, cfg::function cfg>
+class shared_func<R(Args...), cfg> {
+    static_assert(!cfg.require_nothrow_invocable && !cfg.require_const_invocable && !cfg.require_rvalue_invocable,
+        "shared funcs are invoked through R(Args...) invokers: nothrow, const and rvalue invocation are not supported");
+    static_assert(!cfg.enable_typeinfo && !cfg.trace_invocations && !cfg.allow_signature_adaptation,
+        "shared funcs do not support typeinfo, tracing or signature adaptation");
+    static_assert(cfg.copyable && cfg.movable, "shared funcs are always trivially copyable");
+
+public:
+    using registry = shared_registry<R(Args...)>;
+    using id_type = typename registry::id_type;
+
+    template <typename F>
+    static constexpr bool is_storable = std::is_trivially_copyable_v<F> &&
+                                        sizeof(F) <= cfg.SBO &&
+                                        alignof(F) <= cfg.alignment &&
+                                        (cfg.alignment % alignof(F) == 0);
+
+    shared_func() noexcept = default;
+    shared_func(std::nullptr_t) noexcept {}
+
+    /// Throws bad_function_operation if F was not registered in this process
+    template <typename F>
+    shared_func(F callable) requires (is_storable<F> && !std::is_same_v<F, shared_func>)
+    : id{ registry::template id_of<F>() }
+    {
+        if (id == registry::empty_id) { throw bad_function_operation{"shared func type is not registered"}; }
+        std::memcpy(payload, &callable, sizeof(F));
+    }
+
+    R operator() (Args... args) {
+        const auto invoker = registry::at(id);
+        if constexpr (cfg.check_empty) {
+            if (invoker == nullptr) { throw bad_function_call{}; }
+        }
+        return invoker(payload, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] id_type type() const noexcept { return id; }
+
+    template <typename F>
+    [[nodiscard]] F* target() noexcept {
+        return id != registry::empty_id && id == registry::template id_of<F>() ? std::launder(reinterpret_cast<F*>(payload)) : nullptr;
+    }
+
+    explicit operator bool() const noexcept { return id != registry::empty_id; }
+
+private:
+    id_type id { registry::empty_id };
+    alignas(cfg.alignment) std::byte payload [std::max(cfg.SBO, std::size_t{1})] {};
+};
+
+} // namespace vx
@@ -0,0 +1,254 @@
+#pragma once
+
+/// Table-driven finite-state machine with vx::func actions:
+///
+///     enum class conn { idle, connecting, open, closed, count };
+///     enum class ev { dial, ready, hangup, count };              ///< `count` sizes the table (or specialize vx::enum_count)
+///
+///     constexpr auto table = vx::make_transition_table<conn, ev, void(session&)>({
+///         { conn::idle, ev::dial, conn::connecting, &start_dial },
+///         { conn::connecting, ev::ready, conn::open },
+///         { conn::open, ev::hangup, conn::closed, vx::nontype<&session::close> },
+///     }, {
+///         { conn::open, &log_opened, &log_closing },                                 ///< state, entry, exit
+///     });
+///     vx::state_machine<conn, ev, void(session&)> machine { table, conn::idle };   ///< compile-time built table
+///     machine.on_entry(conn::open, [&](session& s) { metrics.opened(s); });       ///< any callable, runtime
+///     machine.dispatch(ev::dial, s);
+///
+/// Transitions live in a dense [state][event] array, so dispatch is an index computation, one load of the cell and
+/// the calls of its actions. Taking a transition to another state runs exit(from) and the transition action, then
+/// switches to `to` and runs entry(to); a transition to the same state only runs its action. Undefined (state, event)
+/// pairs are ignored.
+///
+/// Arguments are passed to every action of a transition: references as given, by-value parameters (which have to be
+/// copyable) are taken by const reference and copied into each action. dispatch() is not reentrant: an action that
+/// dispatches on its own machine gets vx::bad_function_operation (queue the event and dispatch it afterwards).
+/// If exit(from) or the transition action throws, the machine stays in `from` (exit may have run); if entry(to)
+/// throws, it is already in `to`.
+
+#include <array>
+#include <cstddef>
+#include <functional> // std::invoke
+#include <type_traits>
+#include <utility>
+#include "func.hpp"
+
+namespace vx {
+
+/// Number of enumerators of E used as table dimension: E::count by default, specialize for other enums
+template <typename E>
+inline constexpr std::size_t enum_count = static_cast<std::size_t>(E::count);
+
+template <typename State, typename Event, typename Signature>
+struct transition;
+
+/// @brief Compile-time transition: from, on, to and an optional action (function pointer or nontype<fn>)
+template <typename State, typename Event, typename... Args>
+struct transition<State, Event, void(Args...)> {
+    using pointer = void (*)(Args...);
+
+    State from;
+    Event on;
+    State to;
+    pointer action = nullptr;
+
+    constexpr transition(State from, Event on, State to, pointer action = nullptr) noexcept
+    : from{ from }, on{ on }, to{ to }, action{ action } {}
+
+    template <auto fn> requires std::is_invocable_v<decltype(fn), Args...>
+    constexpr transition(State from, Event on, State to, nontype_t<fn>) noexcept
+    : from{ from }, on{ on }, to{ to }
+    , action{ +[](Args... args) { std::invoke(fn, std::forward<Args>(args)...); } }
+    {}
+};
+
+template <typename State, typename Signature>
+struct state_action;
+
+/// @brief Compile-time entry and exit actions of a state (function pointers or nontype<fn>, either may be null)
+template <typename State, typename... Args>
+struct state_action<State, void(Args...)> {
+    using pointer = void (*)(Args...);
+
+    State state;
+    pointer entry = nullptr;
+    pointer exit = nullptr;
+
+    constexpr state_action(State state, pointer entry, pointer exit = nullptr) noexcept
+    : state{ state }, entry{ entry }, exit{ exit } {}
+
+    template <auto entry_fn, auto exit_fn = nullptr>
+    constexpr state_action(State state, nontype_t<entry_fn>, nontype_t<exit_fn> = nontype_t<exit_fn>{}) noexcept
+    : state{ state }, entry{ adapt<entry_fn>() }, exit{ adapt<exit_fn>() } {}
+
+private:
+    template <auto fn>
+    static constexpr pointer adapt() noexcept {
+        if constexpr (std::is_null_pointer_v<decltype(fn)>) {
+            return nullptr;
+        } else {
+            static_assert(std::is_invocable_v<decltype(fn), Args...>, "state_action: fn is not invocable with the arguments");
+            return +[](Args... args) { std::invoke(fn, std::forward<Args>(args)...); };
+        }
+    }
+};
+
+template <typename State, typename Event, typename Signature>
+struct transition_table;
+
+/// @brief Dense [state][event] table of targets and function pointer actions, constexpr/constinit
+template <typename State, typename Event, typename... Args>
+struct transition_table<State, Event, void(Args...)> {
+    using pointer = void (*)(Args...);
+
+    struct cell {
+        State to {};
+        pointer action = nullptr;
+        bool defined = false;
+    };
+
+    std::array<std::array<cell, enum_count<Event>>, enum_count<State>> cells {};
+    std::array<pointer, enum_count<State>> entries {};
+    std::array<pointer, enum_count<State>> exits {};
+};
+
+/// @brief Builds a transition_table at compile time; a repeated (from, on) pair is a compile error
+template <typename State, typename Event, typename Signature, std::size_t N>
+consteval transition_table<State, Event, Signature> make_transition_table(transition<State, Event, Signature> const (&transitions)[N]) {
+    transition_table<State, Event, Signature> table {};
+    for (auto const& t : transitions) {
+        auto& cell = table.cells[static_cast<std::size_t>(t.from)][static_cast<std::size_t>(t.on)];
+        if (cell.defined) { throw "make_transition_table: duplicate transition"; }
+        cell = { t.to, t.action, true };
+    }
+    return table;
+}
+
+/// @brief As above, plus the entry and exit actions of states; a state listed twice is a compile error
+template <typename State, typename Event, typename Signature, std::size_t N, std::size_t M>
+consteval transition_table<State, Event, Signature> make_transition_table(transition<State, Event, Signature> const (&transitions)[N],
+                                                                          state_action<State, Signature> const (&states)[M]) {
+    auto table = make_transition_table(transitions);
+    std::array<bool, enum_count<State>> listed {};
+    for (auto const& s : states) {
+        auto const i = static_cast<std::size_t>(s.state);
+        if (listed[i]) { throw "make_transition_table: duplicate state actions"; }
+        listed[i] = true;
+        table.entries[i] = s.entry;
+        table.exits[i] = s.exit;
+    }
+    return table;
+}
+
+
+template <typename State, typename Event, typename Signature = void(), cfg::function cfg = cfg::function{}>
+class state_machine;
+
+/// @brief Runtime state machine over a dense table of vx::func actions
+template <typename State, typename Event, typename... Args, cfg::function cfg>
+class state_machine<State, Event, void(Args...), cfg> {
+    /// References as declared, by-value parameters as const reference (copied into each action)
+    template <typename T>
+    using parameter = std::conditional_t<std::is_reference_v<T>, T, T const&>;
+
+public:
+    using action_type = func<void(Args...), cfg.with_can_be_empty(true)>;
+
+    static_assert(((std::is_reference_v<Args> || std::is_copy_constructible_v<Args>) && ...),
+        "state_machine passes the arguments to several actions: by-value parameters have to be copyable");
+    using table_type = transition_table<State, Event, void(Args...)>;
+
+    static constexpr std::size_t state_count = enum_count<State>;
+    static constexpr std::size_t event_count = enum_count<Event>;
+
+    explicit state_machine(State initial) noexcept : current{ initial } {}
+
+    /// Takes the transitions and state actions of a compile-time table; function pointer actions are stored without allocation
+    state_machine(table_type const& table, State initial) : current{ initial } {
+        for (std::size_t s = 0; s < state_count; ++s) {
+            if (table.entries[s] != nullptr) { entries[s] = table.entries[s]; }
+            if (table.exits[s] != nullptr) { exits[s] = table.exits[s]; }
+            for (std::size_t e = 0; e < event_count; ++e) {
+                auto const& source = table.cells[s][e];
+                if (!source.defined) { continue; }
+                auto& target = cells[s][e];
+                target.to = source.to;
+                target.defined = true;
+                if (source.action != nullptr) { target.action = source.action; }
+            }
+        }
+    }
+
+    /// Defines (or replaces) the transition from --on--> to
+    template <typename F = std::nullptr_t>
+    state_machine& on(State from, Event on, State to, F && action = nullptr) {
+        auto& target = cells[index(from)][index(on)];
+        target.to = to;
+        target.action = action_type{ std::forward<F>(action) };
+        target.defined = true;
+        return *this;
+    }
+
+    template <typename F>
+    state_machine& on_entry(State state, F && action) {
+        entries[index(state)] = action_type{ std::forward<F>(action) };
+        return *this;
+    }
+
+    template <typename F>
+    state_machine& on_exit(State state, F && action) {
+        exits[index(state)] = action_type{ std::forward<F>(action) };
+        return *this;
+    }
+
+    /// Runs the transition of (state(), event) if there is one; the arguments are passed to every action
+    bool dispatch(Event event, parameter<Args>... args) {
+        if (dispatching) { throw bad_function_operation{"state_machine::dispatch called from one of its actions"}; }
+        auto& cell = cells[index(current)][index(event)];
+        if (!cell.defined) { return false; }
+        dispatch_scope scope { dispatching };
+        if (cell.to == current) {
+            if (cell.action) { cell.action(static_cast<parameter<Args>>(args)...); }
+            return true;
+        }
+        if (auto& exit = exits[index(current)]) { exit(static_cast<parameter<Args>>(args)...); }
+        if (cell.action) { cell.action(static_cast<parameter<Args>>(args)...); }
+        current = cell.to;
+        if (auto& entry = entries[index(current)]) { entry(static_cast<parameter<Args>>(args)...); }
+        return true;
+    }
+
+    [[nodiscard]] bool can_dispatch(Event event) const noexcept {
+        return cells[index(current)][index(event)].defined;
+    }
+
+    [[nodiscard]] State state() const noexcept { return current; }
+
+    /// Jumps to state without running any action
+    void reset(State state) noexcept { current = state; }
+
+private:
+    struct dispatch_scope {
+        bool & flag;
+        explicit dispatch_scope(bool & flag) noexcept : flag{ flag } { flag = true; }
+        ~dispatch_scope() { flag = false; }
+    };
+
+    struct cell {
+        action_type action;
+        State to {};
+        bool defined = false;
+    };
+
+    template <typename E>
+    static constexpr std::size_t index(E value) noexcept { return static_cast<std::size_t>(value); }
+
+    std::array<std::array<cell, event_count>, state_count> cells {};
+    std::array<action_type, state_count> entries {};
+    std::array<action_type, state_count> exits {};
+    State current;
+    bool dispatching = false;
+};
+
+} // namespace vx
@@ -0,0 +1,195 @@
+#pragma once
+
+/// Dispatch from a fixed set of string or integer keys to handlers through a perfect hash built at compile time:
+///
+///     constexpr auto handlers = vx::make_static_dispatch<std::string_view, void(request&)>({
+///         { "GET", &on_get },
+///         { "PUT", vx::nontype<&server::on_put> },   ///< any compile-time callable, baked into a function pointer
+///     });
+///     handlers("GET", req);                    ///< one hash, one key compare, one indirect call
+///     if (auto fn = handlers.find(verb)) { ... }
+///
+/// Values are plain function pointers, i.e. what vx::func stores on its optimize_for_func_ptrs fast path, so the
+/// table is constexpr/constinit (no startup cost) and a found entry converts into a vx::func without allocation.
+///
+/// The hash is PTHash-style: the key is hashed once, the hash picks a bucket, and the bucket's pilot (found at
+/// compile time) scatters the hash into a table slot so that no two keys collide. Duplicate keys or a failed pilot
+/// search make make_static_dispatch a compile error.
+
+#include <algorithm> // std::sort
+#include <array>
+#include <bit> // std::bit_ceil
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::invoke
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "func.hpp"
+
+namespace vx {
+
+namespace detail::perfect_hash {
+
+constexpr std::uint64_t mix(std::uint64_t x) noexcept { ///< splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+constexpr std::uint64_t hash(std::string_view key) noexcept { ///< FNV-1a
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    for (char c : key) { h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull; }
+    return mix(h);
+}
+
+template <typename Key> requires (std::is_integral_v<Key> || std::is_enum_v<Key>)
+constexpr std::uint64_t hash(Key key) noexcept {
+    if constexpr (std::is_enum_v<Key>) {
+        return mix(static_cast<std::uint64_t>(static_cast<std::underlying_type_t<Key>>(key)));
+    } else {
+        return mix(static_cast<std::uint64_t>(key));
+    }
+}
+
+constexpr std::size_t slot_of(std::uint64_t hash, std::uint32_t pilot, std::size_t table_size) noexcept {
+    return mix(hash ^ (pilot * 0x9E3779B97F4A7C15ull)) & (table_size - 1);
+}
+
+constexpr std::size_t bucket_of(std::uint64_t hash, std::size_t bucket_count) noexcept {
+    return (hash >> 32) & (bucket_count - 1);
+}
+
+} // namespace detail::perfect_hash
+
+
+template <typename Key, typename Signature>
+struct dispatch_entry;
+
+/// @brief Key and handler of make_static_dispatch: a function pointer, or nontype<fn> baked into one
+template <typename Key, typename R, typename... Args>
+struct dispatch_entry<Key, R(Args...)> {
+    using pointer = R (*)(Args...);
+
+    Key key;
+    pointer handler;
+
+    constexpr dispatch_entry(Key key, pointer handler) noexcept : key{ key }, handler{ handler } {}
+
+    template <auto fn> requires std::is_invocable_r_v<R, decltype(fn), Args...>
+    constexpr dispatch_entry(Key key, nontype_t<fn>) noexcept
+    : key{ key }
+    , handler{ +[](Args... args) -> R { return R( std::invoke(fn, std::forward<Args>(args)...) ); } }
+    {}
+};
+
+
+template <typename Key, typename Signature, std::size_t N>
+class static_dispatch;
+
+/// @brief Constant perfect-hash table from N keys to function pointers
+template <typename Key, typename R, typename... Args, std::size_t N>
+class static_dispatch<Key, R(Args...), N> {
+public:
+    using entry = dispatch_entry<Key, R(Args...)>;
+    using pointer = typename entry::pointer;
+
+    static constexpr std::size_t table_size = std::bit_ceil(N + N / 4 + 1);
+    static constexpr std::size_t bucket_count = std::bit_ceil(N / 2 + 1);
+
+    /// The handler of key, or nullptr
+    [[nodiscard]] constexpr pointer find(Key key) const noexcept {
+        auto const& s = slot_for(key);
+        return s.key == key ? s.handler : nullptr; ///< empty slots hold a null handler
+    }
+
+    [[nodiscard]] constexpr bool contains(Key key) const noexcept {
+        auto const& s = slot_for(key);
+        return s.occupied && s.key == key;
+    }
+
+    /// Invokes the handler of key; throws vx::bad_function_call for unknown keys
+    constexpr R operator() (Key key, Args... args) const {
+        const auto handler = find(key);
+        if (handler == nullptr) { throw bad_function_call{}; }
+        return handler(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return N; }
+
+    /// Builds the table; only usable in constant evaluation (see make_static_dispatch)
+    consteval explicit static_dispatch(entry const (&entries)[N]) {
+        namespace ph = detail::perfect_hash;
+        std::array<std::uint64_t, N> hashes {};
+        for (std::size_t i = 0; i < N; ++i) {
+            hashes[i] = ph::hash(entries[i].key);
+            for (std::size_t j = 0; j < i; ++j) {
+                if (entries[j].key == entries[i].key) { throw "make_static_dispatch: duplicate key"; }
+            }
+        }
+
+        /// Largest buckets first, each gets the first pilot that maps all its keys to free slots
+        std::array<std::size_t, N> order {};
+        std::array<std::size_t, bucket_count> bucket_sizes {};
+        for (std::size_t i = 0; i < N; ++i) {
+            order[i] = i;
+            ++bucket_sizes[ph::bucket_of(hashes[i], bucket_count)];
+        }
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            const auto ba = ph::bucket_of(hashes[a], bucket_count), bb = ph::bucket_of(hashes[b], bucket_count);
+            return bucket_sizes[ba] != bucket_sizes[bb] ? bucket_sizes[ba] > bucket_sizes[bb] : ba < bb;
+        });
+
+        std::array<bool, table_size> taken {};
+        for (std::size_t first = 0; first < N;) {
+            const auto bucket = ph::bucket_of(hashes[order[first]], bucket_count);
+            const auto last = first + bucket_sizes[bucket];
+            for (std::uint32_t pilot = 0;; ++pilot) {
+                if (pilot == max_pilot) { throw "make_static_dispatch: no perfect hash found"; }
+                bool fits = true;
+                for (std::size_t i = first; i < last && fits; ++i) {
+                    const auto s = ph::slot_of(hashes[order[i]], pilot, table_size);
+                    fits = !taken[s];
+                    for (std::size_t j = first; j < i && fits; ++j) {
+                        fits = ph::slot_of(hashes[order[j]], pilot, table_size) != s;
+                    }
+                }
+                if (!fits) { continue; }
+                pilots[bucket] = pilot;
+                for (std::size_t i = first; i < last; ++i) {
+                    const auto s = ph::slot_of(hashes[order[i]], pilot, table_size);
+                    taken[s] = true;
+                    slots[s] = { entries[order[i]].key, entries[order[i]].handler, true };
+                }
+                break;
+            }
+            first = last;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t max_pilot = 1u << 20;
+
+    struct slot {
+        Key key {};
+        pointer handler = nullptr;
+        bool occupied = false;
+    };
+
+    constexpr slot const& slot_for(Key key) const noexcept {
+        const auto h = detail::perfect_hash::hash(key);
+        return slots[detail::perfect_hash::slot_of(h, pilots[detail::perfect_hash::bucket_of(h, bucket_count)], table_size)];
+    }
+
+    std::array<std::uint32_t, bucket_count> pilots {};
+    std::array<slot, table_size> slots {};
+};
+
+/// @brief Builds a static_dispatch at compile time: make_static_dispatch<Key, Sig>({ { key, handler }, ... })
+template <typename Key, typename Signature, std::size_t N>
+consteval static_dispatch<Key, Signature, N> make_static_dispatch(dispatch_entry<Key, Signature> const (&entries)[N]) {
+    return static_dispatch<Key, Signature, N>{ entries };
+}
+
+} // namespace vx
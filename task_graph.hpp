@@ -0,0 +1,288 @@
+#pragma once
+
+/// Task graph (DAG) of vx::move_only_func<void()> nodes run on a thread pool:
+///
+///     vx::task_graph graph;
+///     auto load = graph.add([&] { ... });
+///     auto parse = graph.add([&] { ... });
+///     auto index = graph.add([&] { ... });
+///     graph.precede(load, parse);     ///< parse runs after load
+///     graph.precede(parse, index);
+///
+///     vx::task_executor pool { 8 };   ///< worker threads (plus the calling thread)
+///     pool.run(graph);                ///< blocks until every task ran; a graph can be run again
+///
+/// Nodes, edges and the per-run state live in flat arrays (closures up to the SBO are stored inline, so adding a task
+/// does not allocate beyond amortized vector growth). Each node has an atomic count of unfinished predecessors; the
+/// thread finishing the last predecessor publishes the node into a ready array that workers claim in order.
+///
+/// The first exception thrown by a task is rethrown by run() after the graph drained (remaining tasks are skipped),
+/// the same on the pool and when the graph runs inline on a single-threaded executor.
+/// A cycle is reported as vx::bad_function_operation before anything runs.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "func.hpp"
+
+namespace vx {
+
+class task_executor;
+
+/// @brief Flat DAG of move-only tasks
+class task_graph {
+public:
+    using node = std::uint32_t;
+    using task_type = move_only_func<void()>;
+
+    template <typename F>
+    node add(F && task) {
+        if (tasks.size() == no_node) { throw bad_function_operation{"task_graph is full"}; }
+        tasks.emplace_back(std::forward<F>(task));
+        prepared = false;
+        return static_cast<node>(tasks.size() - 1);
+    }
+
+    /// after starts only once before has finished
+    void precede(node before, node after) {
+        if (before >= tasks.size() || after >= tasks.size()) { throw bad_function_operation{"task_graph node out of range"}; }
+        edges.push_back({ before, after });
+        prepared = false;
+    }
+
+    void reserve(std::size_t nodes, std::size_t dependencies) {
+        tasks.reserve(nodes);
+        edges.reserve(dependencies);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return tasks.size(); }
+    [[nodiscard]] std::size_t edge_count() const noexcept { return edges.size(); }
+
+    void clear() noexcept {
+        tasks.clear();
+        edges.clear();
+        prepared = false;
+    }
+
+    /// Builds the successor lists in CSR form, predecessor counts and the per-run arrays and checks for cycles (Kahn);
+    /// done by the first run after a change, call it to keep that work out of the run
+    void prepare() {
+        if (prepared) { return; }
+        const auto n = tasks.size();
+        first_successor.assign(n + 1, 0);
+        predecessors.assign(n, 0);
+        for (auto const& e : edges) {
+            ++first_successor[e.before + 1];
+            ++predecessors[e.after];
+        }
+        for (std::size_t i = 0; i < n; ++i) { first_successor[i + 1] += first_successor[i]; }
+        successors.resize(edges.size());
+        {
+            auto fill = first_successor;
+            for (auto const& e : edges) { successors[fill[e.before]++] = e.after; }
+        }
+
+        std::vector<node> order;
+        order.reserve(n);
+        auto remaining = predecessors;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (remaining[i] == 0) { order.push_back(static_cast<node>(i)); }
+        }
+        for (std::size_t k = 0; k < order.size(); ++k) {
+            for (auto s = first_successor[order[k]]; s < first_successor[order[k] + 1]; ++s) {
+                if (--remaining[successors[s]] == 0) { order.push_back(successors[s]); }
+            }
+        }
+        if (order.size() != n) { throw bad_function_operation{"task_graph has a cycle"}; }
+
+        pending = std::make_unique<std::atomic<std::uint32_t>[]>(n);
+        ready = std::make_unique<std::atomic<node>[]>(n);
+        prepared = true;
+    }
+
+private:
+    friend class task_executor;
+
+    static constexpr node no_node = ~node{0};
+
+    struct edge {
+        node before;
+        node after;
+    };
+
+    std::vector<task_type> tasks;
+    std::vector<edge> edges;
+
+    bool prepared = false;
+    std::vector<std::uint32_t> first_successor;
+    std::vector<node> successors;
+    std::vector<std::uint32_t> predecessors;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> pending;
+    std::unique_ptr<std::atomic<node>[]> ready;
+};
+
+
+/// @brief Thread pool running task_graphs; one graph at a time, the calling thread participates
+class task_executor {
+public:
+    explicit task_executor(std::size_t threads = std::thread::hardware_concurrency()) {
+        const auto workers = threads > 1 ? threads - 1 : 0;
+        pool.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) { pool.emplace_back([this] { worker(); }); }
+    }
+
+    ~task_executor() {
+        {
+            std::lock_guard lock{ mutex };
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : pool) { t.join(); }
+    }
+
+    task_executor(task_executor const&) = delete;
+    task_executor& operator= (task_executor const&) = delete;
+
+    [[nodiscard]] std::size_t concurrency() const noexcept { return pool.size() + 1; }
+
+    /// Runs every task of graph once, respecting the dependencies; not reentrant
+    void run(task_graph & graph) {
+        graph.prepare();
+        const auto n = static_cast<task_graph::node>(graph.tasks.size());
+        if (n == 0) { return; }
+        if (pool.empty()) {
+            run_inline(graph);
+            return;
+        }
+
+        for (task_graph::node i = 0; i < n; ++i) {
+            graph.pending[i].store(graph.predecessors[i], std::memory_order_relaxed);
+            graph.ready[i].store(task_graph::no_node, std::memory_order_relaxed);
+        }
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        failure = nullptr;
+        failed.store(false, std::memory_order_relaxed);
+        for (task_graph::node i = 0; i < n; ++i) {
+            if (graph.predecessors[i] == 0) { publish(graph, i); }
+        }
+
+        {
+            std::lock_guard lock{ mutex };
+            current = &graph;
+            busy = pool.size();
+            ++generation;
+        }
+        wake.notify_all();
+        work(graph);
+        {
+            std::unique_lock lock{ mutex };
+            idle.wait(lock, [this] { return busy == 0; });
+            current = nullptr;
+        }
+        if (failure) { std::rethrow_exception(failure); }
+    }
+
+private:
+    /// Without workers: the same ready-array traversal with plain loads and stores instead of read-modify-writes
+    /// Same failure policy as the pool: the first exception is kept, later task bodies are skipped, the graph drains
+    static void run_inline(task_graph & graph) {
+        const auto n = graph.tasks.size();
+        std::size_t published = 0;
+        std::exception_ptr first_failure;
+        for (task_graph::node i = 0; i < n; ++i) {
+            graph.pending[i].store(graph.predecessors[i], std::memory_order_relaxed);
+            if (graph.predecessors[i] == 0) { graph.ready[published++].store(i, std::memory_order_relaxed); }
+        }
+        for (std::size_t slot = 0; slot < n; ++slot) {
+            const auto node = graph.ready[slot].load(std::memory_order_relaxed);
+            if (!first_failure) {
+                try {
+                    graph.tasks[node]();
+                } catch (...) {
+                    first_failure = std::current_exception();
+                }
+            }
+            for (auto s = graph.first_successor[node]; s < graph.first_successor[node + 1]; ++s) {
+                const auto next = graph.successors[s];
+                const auto left = graph.pending[next].load(std::memory_order_relaxed) - 1;
+                graph.pending[next].store(left, std::memory_order_relaxed);
+                if (left == 0) { graph.ready[published++].store(next, std::memory_order_relaxed); }
+            }
+        }
+        if (first_failure) { std::rethrow_exception(first_failure); }
+    }
+
+    void publish(task_graph & graph, task_graph::node n) noexcept {
+        const auto slot = tail.fetch_add(1, std::memory_order_relaxed);
+        graph.ready[slot].store(n, std::memory_order_release);
+        graph.ready[slot].notify_one();
+    }
+
+    /// Claims ready slots in order until all nodes are claimed; each claimed slot is filled eventually
+    void work(task_graph & graph) {
+        const auto n = graph.tasks.size();
+        for (;;) {
+            const auto slot = head.fetch_add(1, std::memory_order_relaxed);
+            if (slot >= n) { return; }
+            graph.ready[slot].wait(task_graph::no_node, std::memory_order_acquire);
+            const auto node = graph.ready[slot].load(std::memory_order_acquire);
+
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    graph.tasks[node]();
+                } catch (...) {
+                    std::lock_guard lock{ mutex };
+                    if (!failure) { failure = std::current_exception(); }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            for (auto s = graph.first_successor[node]; s < graph.first_successor[node + 1]; ++s) {
+                const auto next = graph.successors[s];
+                if (graph.pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1) { publish(graph, next); }
+            }
+        }
+    }
+
+    void worker() {
+        std::uint64_t seen = 0;
+        for (;;) {
+            task_graph * graph;
+            {
+                std::unique_lock lock{ mutex };
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) { return; }
+                seen = generation;
+                graph = current;
+            }
+            work(*graph);
+            {
+                std::lock_guard lock{ mutex };
+                if (--busy == 0) { idle.notify_one(); }
+            }
+        }
+    }
+
+    std::vector<std::thread> pool;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    task_graph * current = nullptr;
+    std::size_t busy = 0;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+
+    alignas(64) std::atomic<std::size_t> head {0};
+    alignas(64) std::atomic<std::size_t> tail {0};
+    std::atomic<bool> failed {false};
+    std::exception_ptr failure;
+};
+
+} // namespace vx
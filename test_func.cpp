@@ -1,10 +1,26 @@
 #include <iostream>
 #include <new>
 #include <cassert>
+#include <cstdio> // std::tmpfile
+#include <cstdlib> // std::qsort
+#include <cstring> // std::memcpy
 #include <sstream>
+#include <thread>
+#include <stdexcept> // std::runtime_error
 #include <cstddef> // sized ints
 #include <functional>
+#include <memory>
+#include <vector>
 #include "func.hpp"
+#include "thunk.hpp"
+#include "shared_func.hpp"
+#include "flight_recorder.hpp"
+#include "func_slot_map.hpp"
+#include "bind_weak.hpp"
+#include "static_dispatch.hpp"
+#include "concurrent_func_map.hpp"
+#include "state_machine.hpp"
+#include "task_graph.hpp"
 #include "time.hpp"
 
 using u8 = std::uint8_t;
@@ -132,6 +148,78 @@ struct Test {
 };
 
 
+struct SharedAdd {
+    int k;
+    int operator()(int x) const { return x + k; }
+};
+
+struct Counter {
+    int n = 0;
+    int bump(int by) { return n += by; }
+    static int twice(int x) { return 2 * x; }
+};
+
+struct Widget : vx::weakly_referenced<Widget> {
+    int clicks = 0;
+    void click(int by) { clicks += by; }
+    int total() const { return clicks; }
+};
+
+enum class Opcode : std::uint8_t { load = 1, store = 7, halt = 200 };
+
+constexpr auto verbs = vx::make_static_dispatch<std::string_view, int(int)>({
+    { "GET", &Counter::twice },
+    { "PUT", vx::nontype<[](int x) { return x + 1; }> },
+    { "DELETE", vx::nontype<[](long x) { return x - 1; }> },
+});
+
+constinit auto opcodes = vx::make_static_dispatch<Opcode, int(int)>({
+    { Opcode::load, &Counter::twice },
+    { Opcode::halt, vx::nontype<[](int) { return 0; }> },
+});
+
+enum class Link { idle, connecting, open, closed, count };
+enum class LinkEvent { dial, ready, hangup, count };
+
+struct Session {
+    std::string log;
+    void close() { log += "close;"; }
+    static void dial(Session& s) { s.log += "dial;"; }
+};
+
+constexpr auto link_table = vx::make_transition_table<Link, LinkEvent, void(Session&)>({
+    { Link::idle, LinkEvent::dial, Link::connecting, &Session::dial },
+    { Link::connecting, LinkEvent::ready, Link::open },
+    { Link::open, LinkEvent::ready, Link::open, vx::nontype<[](Session& s) { s.log += "ready;"; }> },
+    { Link::open, LinkEvent::hangup, Link::closed, vx::nontype<&Session::close> },
+}, {
+    { Link::connecting, nullptr, +[](Session& s) { s.log += "connected;"; } },
+    { Link::closed, vx::nontype<[](Session& s) { s.log += "closed;"; }> },
+});
+
+struct CountCalls {
+    static inline int before_calls = 0;
+    static inline int after_calls = 0;
+    static void before(auto const&...) { ++before_calls; }
+    static void after() { ++after_calls; }
+};
+
+struct Doubling {
+    static decltype(auto) around(auto&& next, auto&&... args) { return 2 * next(args...); }
+};
+
+struct CallBudget {
+    static inline int left = 0;
+    static void before(auto const&...) { if (left-- == 0) { throw std::runtime_error("budget exhausted"); } }
+};
+
+struct ErrorToMinusOne {
+    static int around(auto&& next, auto&&... args) noexcept {
+        try { return next(args...); } catch (...) { return -1; }
+    }
+};
+
+
 template <typename func, std::size_t Sz=0>
 constexpr auto test1() { 
     {
@@ -464,6 +552,544 @@ int main() {
         f2();
     }
 
+    /// One-shot (rvalue) invocation: invoke + destroy in a single call
+    {
+        static int destroyed = 0;
+        struct Probe { 
+            ~Probe() { ++destroyed; } 
+        };
+
+        std::vector<int> buffer (100, 1);
+        vx::move_only_func<std::size_t() &&> task = [buf = std::move(buffer), p = std::make_unique<Probe>()]() mutable {
+            auto stolen = std::move(buf); ///< captured state can be moved out
+            return stolen.size();
+        };
+
+        static_assert( not std::is_invocable_v<decltype(task)&> );
+        static_assert( std::is_invocable_v<decltype(task)&&> );
+
+        assert(std::move(task)() == 100);
+        assert(destroyed == 1); ///< destroyed by the same invoker
+        assert(!task); ///< and left in the moved-from state
+
+        vx::move_only_func<void() &&> throwing = [p = std::make_unique<Probe>()]{ throw 42; };
+        try {
+            std::move(throwing)();
+            assert(false);
+        } catch (int) {
+            assert(destroyed == 2 && !throwing);
+        }
+    }
+
+    /// Closed set of callables: func_variant
+    {
+        struct Inc { int operator()(int x) const noexcept { return x + 1; } };
+        struct Mul { int k; int operator()(int x) const noexcept { return x * k; } };
+        struct Str { std::string s; int operator()(int x) const noexcept { return x + int(s.size()); } };
+
+        vx::func_variant<int(int) const, Inc, Mul, Str> f = Mul{3};
+        assert(f(2) == 6);
+        f = Str{"hello"};
+        assert(f(2) == 7 && f.index() == 2);
+        static_assert(![]<typename V>(V&) { return requires (V& v) { v.template target<Str>(); }; }(f)); ///< needs cfg.enable_typeinfo
+
+        auto copy = f;
+        auto moved = std::move(copy);
+        assert(!copy && moved(0) == 5);
+
+        static_assert( sizeof(vx::func_variant<int(int), Inc, Mul>) == 2 * sizeof(int) ); ///< storage + index, no pointers
+
+        constexpr vx::cfg::function empty_cfg = {
+            .enable_typeinfo = true,
+            .can_be_empty = true,
+            .check_empty = true,
+            .copyable = false
+        };
+
+        vx::basic_func_variant<int(int) noexcept, empty_cfg, Inc, Mul> e;
+        try {
+            e(1);
+            assert(false);
+        } catch (vx::bad_function_call const&) {
+            e = Inc{};
+        }
+        assert(e(1) == 2 && e.target_type() == typeid(Inc));
+        assert(e.target<Inc>() != nullptr && e.target<Mul>() == nullptr);
+        static_assert( not std::is_copy_constructible_v<decltype(e)> );
+    }
+
+    /// trivial_abi: register-passable funcs
+    {
+        /// no heap & no typeinfo => trivially copyable, SBO + invoker only
+        constexpr vx::cfg::function register_cfg = {
+            .SBO = 8,
+            .alignment = alignof(void*),
+            .trivial_abi = true,
+            .allow_heap = false
+        };
+        using callback = vx::func<int(int) const, register_cfg>;
+        static_assert( std::is_trivially_copyable_v<callback> );
+        static_assert( sizeof(callback) == 2 * sizeof(void*) ); ///< passed in two registers
+
+        int k = 3;
+        callback f = [k](int x){ return x * k; };
+        callback g = f;
+        assert(g(2) == 6);
+        callback moved = std::move(f);
+        assert(moved(2) == 6 && f && f(1) == 3); ///< moves are copies: the moved-from func keeps its callable
+
+        /// heap allowed => bitwise relocatable ([[clang::trivial_abi]] under Clang), 
+        /// non-trivially copyable callables are kept on the heap
+        constexpr vx::cfg::function relocatable_cfg = {
+            .trivial_abi = true,
+            .copyable = false
+        };
+        static_assert( not vx::is_sbo_eligible<vx::func<int(int), relocatable_cfg>, std::string> );
+
+        vx::func<int(int), relocatable_cfg> h = [s = std::string("abc")](int x){ return x + int(s.size()); };
+        vx::func<int(int), relocatable_cfg> h2 = std::move(h);
+        assert(h2(1) == 4 && !h); ///< non-trivial func_base: moved-from is empty
+    }
+
+    /// nontype<&fn>: target known at compile time
+    {
+        vx::func<int(int)> f = vx::nontype<&Counter::twice>; ///< no storage, twice() is inlined into the thunk
+        assert(f(4) == 8);
+
+        Counter c;
+        vx::func<int(int)> g {vx::nontype<&Counter::bump>, &c}; ///< only &c is stored
+        g(2);
+        g(3);
+        assert(c.n == 5);
+
+        constexpr vx::cfg::function typeinfo_cfg = {
+            .optimize_for_func_ptrs = false,
+            .enable_typeinfo = true
+        };
+        vx::func<int(int), typeinfo_cfg> h = vx::nontype<&Counter::twice>;
+        assert(h(5) == 10 && h.target<vx::nontype_t<&Counter::twice>>() != nullptr);
+
+        /// The result converts implicitly, like for any other callable
+        struct OnlyExplicit { explicit OnlyExplicit(int) {} };
+        vx::func<long(int)> widened = vx::nontype<&Counter::twice>;
+        assert(widened(3) == 6);
+        static_assert(!std::is_constructible_v<vx::func<OnlyExplicit(int)>, vx::nontype_t<&Counter::twice>>);
+        static_assert(!std::is_constructible_v<vx::func<long(int), vx::cfg::function{ .allow_return_type_conversion = false }>,
+            vx::nontype_t<&Counter::twice>>);
+    }
+
+    /// Signature adaptation without nested type erasure
+    {
+        struct Scale {
+            char padding[24];
+            int k;
+            int operator()(int x) const { return x * k; }
+        };
+
+        constexpr vx::cfg::function source_cfg = {
+            .enable_typeinfo = true
+        };
+
+        constexpr vx::cfg::function adapting_cfg = {
+            .allow_signature_adaptation = true,
+            .enable_typeinfo = true
+        };
+
+        vx::func<int(int), source_cfg> f = Scale{{}, 3};
+        vx::func<long(long), adapting_cfg> g = std::move(f);
+        assert(!f && g(5) == 15);
+        assert(g.target<Scale>() != nullptr); ///< the original storage is kept, not wrapped
+
+        auto copy = g;
+        assert(copy(2) == 6);
+
+        vx::func<int(int), source_cfg> fptr = +[](int x){ return x + 1; };
+        vx::func<double(int), adapting_cfg> h = std::move(fptr);
+        assert(h(1) == 2.0);
+    }
+
+    /// Executable thunks (plain function pointers without a context argument)
+#if VX_HAS_THUNKS
+    {
+        int calls = 0;
+        vx::thunk<int(const void*, const void*)> cmp {[&](const void* a, const void* b) {
+            ++calls;
+            return *static_cast<const int*>(a) - *static_cast<const int*>(b);
+        }};
+        int xs[] = { 5, 3, 9, 1, 7 };
+        std::qsort(xs, 5, sizeof(int), cmp.get());
+        assert(xs[0] == 1 && xs[4] == 9 && calls > 0);
+
+        vx::thunk<double(double, int, float)> mixed {[k = 2](double a, int b, float c) { return a * b + c + k; }};
+        auto fptr = mixed.get();
+        assert(fptr(1.5, 2, 0.5f) == 5.5);
+        auto moved = std::move(mixed);
+        assert(moved.get() == fptr && fptr(1.0, 1, 1.0f) == 4.0);
+        assert(mixed.get() == nullptr); ///< moved-from
+        static_assert(vx::detail::is_thunk_scalar<long long&> && !vx::detail::is_thunk_scalar<long double>);
+#if defined __SIZEOF_INT128__
+        static_assert(!vx::detail::is_thunk_scalar<__int128>); ///< register pair
+#endif
+
+        std::vector<vx::thunk<int(int)>> many;
+        many.reserve(500);
+        for (int i = 0; i < 500; ++i) { many.emplace_back([i](int x){ return x + i; }); }
+        for (int i = 0; i < 500; ++i) { assert(many[i].get()(1) == i + 1); }
+    }
+#endif
+
+    /// Process-shared func (type ID + inline payload)
+    {
+        using shared = vx::shared_func<int(int)>;
+        static_assert(std::is_trivially_copyable_v<shared>);
+
+        vx::shared_registry<int(int)>::add<SharedAdd>(1);
+        vx::shared_registry<int(int)>::add<SharedAdd>(1); ///< same pair again is fine
+        auto twice = [](int x) { return 2 * x; };
+        try {
+            vx::shared_registry<int(int)>::add<decltype(twice)>(1); ///< ID taken by another type
+            assert(false);
+        } catch (vx::bad_function_operation const&) {}
+
+        alignas(shared) std::byte ring [2 * sizeof(shared)]; ///< stands in for a shared memory segment
+        shared task = SharedAdd{ 5 };
+        std::memcpy(ring + sizeof(shared), &task, sizeof(shared));
+
+        shared received;
+        std::memcpy(&received, ring + sizeof(shared), sizeof(shared));
+        assert(received(1) == 6 && received.type() == 1 && received.target<SharedAdd>()->k == 5);
+
+        struct Unregistered { int operator()(int x) const { return x; } };
+        try {
+            [[maybe_unused]] shared unregistered = Unregistered{};
+            assert(false);
+        } catch (vx::bad_function_operation const&) {}
+    }
+
+    /// Allocation-free region guard
+    {
+        struct Spilling {
+            char padding[64];
+            int operator()(int x) const { return x + padding[0]; }
+        };
+
+        vx::func<int(int)> outside = Spilling{};
+        {
+            vx::no_heap_scope guard;
+            vx::func<int(int)> small = [](int x){ return x; };
+            auto moved = std::move(outside); ///< moves only transfer the pointer
+            assert(small(1) == 1 && moved(1) == 1);
+#if defined VX_FUNC_HEAP_GUARD
+            try {
+                vx::func<int(int)> spilled = Spilling{};
+                assert(false);
+            } catch (vx::bad_function_operation const& e) {
+                assert(std::string{e.what()}.find("Spilling") != std::string::npos);
+            }
+#endif
+        }
+        vx::func<int(int)> allowed = Spilling{};
+        auto copy = allowed;
+        assert(copy(1) == 1);
+    }
+
+    /// Flight recorder (Chrome trace export)
+    {
+        constexpr vx::cfg::function traced = {
+            .trace_invocations = true
+        };
+
+        vx::func<int(int), traced> f = SharedAdd{ 2 };
+        int sum = 0;
+        for (int i = 0; i < 10; ++i) { sum += f(i); }
+        assert(sum == 65);
+
+        std::FILE * json = std::tmpfile();
+        assert(json != nullptr && vx::flight_recorder::dump_chrome_json(json));
+        std::rewind(json);
+        std::string text;
+        for (int c = std::fgetc(json); c != EOF; c = std::fgetc(json)) { text += char(c); }
+        std::fclose(json);
+        assert(text.find("\"traceEvents\"") != std::string::npos);
+        assert(text.find("\"name\":\"SharedAdd\"") != std::string::npos && text.find("\"ph\":\"X\"") != std::string::npos);
+
+        /// Rings of exited threads are taken over by new ones
+        const auto rings_before = vx::flight_recorder::detail::ring_count.load();
+        for (int round = 0; round < 8; ++round) {
+            std::thread{ [&f] { assert(f(1) == 3); } }.join();
+        }
+        assert(vx::flight_recorder::detail::ring_count.load() <= rings_before + 1);
+    }
+
+    /// Interceptors fused into the invoker
+    {
+        using plain = vx::func<int(int)>;
+        using counted = vx::func<int(int), vx::cfg::function{}, CountCalls, Doubling>;
+        static_assert(sizeof(counted) == sizeof(plain));
+        static_assert(counted::is_sbo_eligible<SharedAdd> == plain::is_sbo_eligible<SharedAdd>);
+
+        counted f = SharedAdd{ 3 };
+        assert(f(1) == 8);
+        assert(CountCalls::before_calls == 1 && CountCalls::after_calls == 1);
+        auto g = f;
+        assert(g(0) == 6);
+        counted p = Counter::twice;
+        assert(p(2) == 8);
+        counted n = vx::nontype<&Counter::twice>;
+        assert(n(3) == 12);
+        Counter c;
+        counted b { vx::nontype<&Counter::bump>, &c };
+        assert(b(5) == 10 && c.n == 5);
+        assert(CountCalls::before_calls == 5 && CountCalls::after_calls == 5);
+
+        vx::func<int(int), vx::cfg::function{}, ErrorToMinusOne, CountCalls> translated = [](int x) -> int {
+            if (x < 0) { throw std::runtime_error("negative"); }
+            return x;
+        };
+        assert(translated(4) == 4 && translated(-4) == -1);
+        assert(CountCalls::before_calls == 7 && CountCalls::after_calls == 7); ///< after() also runs on throw
+
+        vx::func<int(int) const, vx::cfg::function{ .can_be_empty = true, .check_empty = true }, CountCalls> empty;
+        assert(!empty);
+        empty = [](int x) { return -x; };
+        assert(empty(1) == -1);
+
+        /// A throwing hook around a noexcept callable propagates (noexcept follows the whole chain)
+        using budgeted = vx::func<int(int), vx::cfg::function{}, CallBudget>;
+        static_assert(!std::is_base_of_v<plain, budgeted>);
+        budgeted limited = [](int x) noexcept { return x + 1; };
+        static_assert(!noexcept(limited(0)));
+        CallBudget::left = 1;
+        assert(limited(1) == 2);
+        bool threw = false;
+        try { limited(2); } catch (std::runtime_error const&) { threw = true; }
+        assert(threw);
+    }
+
+    /// Slot map with generational handles
+    {
+        vx::func_slot_map<void(int&)> handlers;
+        using handle = decltype(handlers)::handle;
+        assert(!handlers.contains(handle{}));
+
+        const auto a = handlers.insert([](int& x) { x += 1; });
+        const auto b = handlers.insert([](int& x) { x += 10; });
+        const auto c = handlers.insert([](int& x) { x += 100; });
+        int sum = 0;
+        handlers.for_each_invoke(sum);
+        assert(sum == 111);
+
+        assert(handlers.erase(a) && !handlers.erase(a) && handlers.size() == 2);
+        assert(handlers.find(a) == nullptr);
+        const auto d = handlers.insert([](int& x) { x += 1000; });
+        assert(d.index == a.index && !handlers.contains(a)); ///< the slot is reused under a new generation
+
+        sum = 0;
+        handlers.at(c)(sum);
+        assert(sum == 100);
+        sum = 0;
+        handlers.for_each_invoke(sum);
+        assert(sum == 1110);
+
+        handlers.erase(b);
+        handlers.clear();
+        assert(handlers.empty() && !handlers.contains(c) && !handlers.contains(d));
+        try {
+            handlers.at(d)(sum);
+            assert(false);
+        } catch (vx::bad_function_operation const&) {}
+        const auto reused = handlers.insert([](int& s) { s += 5; }); ///< takes a freed slot
+        assert(handlers.size() == 1 && handlers.contains(reused) && !handlers.contains(c) && !handlers.contains(d));
+    }
+
+    /// Weak binding through generational handles
+    {
+        auto widget = std::make_unique<Widget>();
+        vx::func<void(int)> click = vx::bind_weak(widget->weak_ref(), &Widget::click);
+        vx::func<void(int)> compact = vx::bind_weak<&Widget::click>(widget->weak_ref());
+        vx::func<std::optional<int>()> total = vx::bind_weak<&Widget::total>(widget->weak_ref());
+        static_assert(sizeof(vx::bind_weak<&Widget::click>(widget->weak_ref())) == sizeof(std::uint64_t));
+        static_assert(decltype(click)::is_sbo_eligible<decltype(vx::bind_weak(widget->weak_ref(), &Widget::click))>);
+
+        click(1);
+        compact(2);
+        assert(widget->clicks == 3 && total() == 3);
+
+        const auto handle = widget->weak_ref();
+        Widget copy = *widget;
+        assert(copy.weak_ref() != handle && copy.weak_ref().get() == &copy);
+        widget.reset();
+        assert(handle.expired() && vx::weak_handle<Widget>{}.expired());
+        click(4); ///< no-op
+        compact(4);
+        assert(!total().has_value());
+
+        auto reused = std::make_unique<Widget>(); ///< takes the freed slot under a new generation
+        assert(handle.expired() && !reused->weak_ref().expired());
+    }
+
+    /// Compile-time perfect-hash dispatch
+    {
+        static_assert(verbs.size() == 3 && verbs.contains("GET") && !verbs.contains("HEAD"));
+        assert(verbs.find("GET") == &Counter::twice);
+
+        const std::string put = "PUT";
+        assert(verbs("GET", 2) == 4 && verbs(put, 2) == 3 && verbs("DELETE", 2) == 1);
+        assert(verbs.find("") == nullptr && verbs.find("GETS") == nullptr);
+        try {
+            verbs("HEAD", 0);
+            assert(false);
+        } catch (vx::bad_function_call const&) {}
+
+        assert(opcodes(Opcode::load, 3) == 6 && opcodes(Opcode::halt, 3) == 0 && !opcodes.contains(Opcode::store));
+
+        vx::func<int(int)> f = verbs.find("PUT"); ///< fptr fast path, nothing stored
+        assert(f(1) == 2);
+    }
+
+    /// Concurrent read-mostly handler map
+    {
+        vx::concurrent_func_map<std::uint32_t, int(int)> handlers;
+        assert(handlers.insert_or_assign(1, SharedAdd{ 1 }));
+        assert(!handlers.insert_or_assign(1, SharedAdd{ 2 })); ///< replaced
+        assert(handlers.invoke(1, 1) == 3 && handlers.size() == 1 && handlers.contains(1));
+        assert(!handlers.try_invoke(2, 0).has_value() && handlers.try_invoke(1, 0) == 2);
+        try {
+            handlers.invoke(2, 0);
+            assert(false);
+        } catch (vx::bad_function_call const&) {}
+
+        std::atomic<bool> done { false };
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 2; ++t) {
+            readers.emplace_back([&] {
+                while (!done.load()) {
+                    for (std::uint32_t key = 1; key < 16; ++key) {
+                        if (auto result = handlers.try_invoke(key, 0)) { assert(*result == (key == 1 ? 2 : int(key))); }
+                    }
+                }
+            });
+        }
+        for (int round = 0; round < 50; ++round) { ///< old tables are reclaimed while readers are running
+            for (std::uint32_t key = 2; key < 16; ++key) {
+                if (round % 2 == 0) { handlers.insert_or_assign(key, SharedAdd{ int(key) }); }
+                else { assert(handlers.erase(key)); }
+            }
+        }
+        done = true;
+        for (auto& reader : readers) { reader.join(); }
+        assert(handlers.size() == 1 && !handlers.erase(2));
+    }
+
+    /// Table-driven state machine
+    {
+        static_assert(link_table.cells[size_t(Link::open)][size_t(LinkEvent::hangup)].to == Link::closed);
+        static_assert(!link_table.cells[size_t(Link::idle)][size_t(LinkEvent::hangup)].defined);
+        static_assert(link_table.exits[size_t(Link::connecting)] != nullptr && link_table.entries[size_t(Link::open)] == nullptr);
+
+        vx::state_machine<Link, LinkEvent, void(Session&)> link { link_table, Link::idle };
+        link.on_entry(Link::open, [](Session& s) { s.log += "enter;"; })
+            .on_exit(Link::open, [](Session& s) { s.log += "exit;"; });
+
+        Session session;
+        assert(!link.dispatch(LinkEvent::ready, session) && link.state() == Link::idle);
+        assert(link.dispatch(LinkEvent::dial, session) && link.state() == Link::connecting);
+        assert(link.dispatch(LinkEvent::ready, session) && link.dispatch(LinkEvent::ready, session)); ///< self-transition: action only
+        assert(link.dispatch(LinkEvent::hangup, session) && link.state() == Link::closed);
+        assert(session.log == "dial;connected;enter;ready;exit;close;closed;");
+
+        int dials = 0;
+        vx::state_machine<Link, LinkEvent> runtime { Link::idle };
+        runtime.on(Link::idle, LinkEvent::dial, Link::open, [&dials] { ++dials; })
+               .on(Link::open, LinkEvent::hangup, Link::idle);
+        assert(runtime.dispatch(LinkEvent::dial) && runtime.dispatch(LinkEvent::hangup) && runtime.dispatch(LinkEvent::dial));
+        assert(dials == 2 && runtime.state() == Link::open && !runtime.can_dispatch(LinkEvent::dial));
+
+        /// Transition actions still see the source state; dispatching from an action is rejected
+        vx::state_machine<Link, LinkEvent, void(std::string const&)> nested { Link::idle };
+        std::string seen;
+        nested.on(Link::idle, LinkEvent::dial, Link::open, [&](std::string const& who) {
+            seen = who + (nested.state() == Link::open ? ":open" : ":idle");
+            try { nested.dispatch(LinkEvent::hangup, who); } catch (vx::bad_function_operation const&) { seen += ":rejected"; }
+        }).on(Link::open, LinkEvent::hangup, Link::closed);
+        assert(nested.dispatch(LinkEvent::dial, "alice") && seen == "alice:idle:rejected" && nested.state() == Link::open);
+        assert(nested.dispatch(LinkEvent::hangup, "alice") && nested.state() == Link::closed);
+
+        /// A throwing transition action leaves the machine in the source state, entry(to) doesn't run
+        vx::state_machine<Link, LinkEvent> failing { Link::idle };
+        bool fail = true, entered = false;
+        failing.on(Link::idle, LinkEvent::dial, Link::open, [&fail] { if (fail) { throw std::runtime_error{"busy"}; } })
+               .on_entry(Link::open, [&entered] { entered = true; });
+        try { failing.dispatch(LinkEvent::dial); assert(false); } catch (std::runtime_error const&) {}
+        assert(failing.state() == Link::idle && !entered);
+        fail = false;
+        assert(failing.dispatch(LinkEvent::dial) && failing.state() == Link::open && entered);
+
+        /// By-value parameters are taken by const reference: one copy per action, none into dispatch
+        vx::state_machine<Link, LinkEvent, void(std::string)> by_value { Link::idle };
+        std::string last;
+        by_value.on(Link::idle, LinkEvent::dial, Link::open, [&](std::string who) { last = std::move(who); })
+                .on_entry(Link::open, [&](std::string who) { last += "+" + who; });
+        const std::string caller = "bob";
+        assert(by_value.dispatch(LinkEvent::dial, caller) && last == "bob+bob" && caller == "bob");
+    }
+
+    /// Task graph
+    {
+        vx::task_graph graph;
+        std::atomic<int> clock { 0 };
+        std::vector<int> finished(64, -1);
+        for (int i = 0; i < 64; ++i) {
+            graph.add([&clock, &finished, i] { finished[i] = clock.fetch_add(1); });
+        }
+        std::vector<std::pair<vx::task_graph::node, vx::task_graph::node>> edges;
+        for (vx::task_graph::node i = 1; i < 64; ++i) {
+            edges.push_back({ i - 1, i });
+            edges.push_back({ i / 2, i });
+        }
+        for (auto [before, after] : edges) { graph.precede(before, after); }
+
+        /// Same failure policy inline (one thread) and on the pool: the first exception is rethrown after the graph
+        /// drained, successors of the failed task are skipped, and the graph can be run again
+        vx::task_graph failing;
+        bool fail = true;
+        int ran = 0;
+        const auto thrower = failing.add([&fail, &ran] { if (fail) { throw std::runtime_error("task"); } ++ran; });
+        const auto dependent = failing.add([&fail, &ran] { if (fail) { throw std::logic_error("skipped"); } ++ran; });
+        failing.precede(thrower, dependent);
+        failing.precede(dependent, failing.add([&ran] { ++ran; }));
+
+        for (std::size_t threads : { 1, 3 }) {
+            vx::task_executor pool { threads };
+            for (int run = 0; run < 2; ++run) {
+                clock = 0;
+                pool.run(graph);
+                assert(clock == 64);
+                for (auto [before, after] : edges) { assert(finished[before] < finished[after]); }
+            }
+
+            fail = true;
+            ran = 0;
+            try {
+                pool.run(failing);
+                assert(false);
+            } catch (std::runtime_error const&) {}
+            assert(ran == 0);
+            fail = false;
+            pool.run(failing);
+            assert(ran == 3);
+        }
+
+        vx::task_graph cyclic;
+        const auto a = cyclic.add([] {}), b = cyclic.add([] {});
+        cyclic.precede(a, b);
+        cyclic.precede(b, a);
+        try {
+            vx::task_executor{ 1 }.run(cyclic);
+            assert(false);
+        } catch (vx::bad_function_operation const&) {}
+    }
+
     /// Micro bench
     {
         constexpr std::size_t N = 1'000'000;
@@ -488,67 +1114,72 @@ int main() {
             .movable = false
         };
 
-        using time_units = vx::time::ms;
-
-        std::cerr << "\n\nBenchmarking function ptr times:";
+        std::cerr << "\n\nBenchmarking function ptr times (cycles/call):";
 
         // std::function
         std::cerr << "\nstd::function: " << vx::timeit([&, f = std::function<void()>(+[]{ })]{
             // std::function<void()> f = +[]{ };
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         // std::move_only_function
         #if defined __cpp_lib_move_only_function
         std::cerr << "\nstd::move_only_function: " << vx::timeit([&]{
             std::move_only_function<void()> f = +[]{ };
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
         #endif
 
         // Default
         std::cerr << "\ndefault: " << vx::timeit([&]{
             vx::func<void(), inplace_cfg> f = +[]{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         // Optimized
         std::cerr << "\noptimized: " << vx::timeit([&]{
             vx::func<void(), optimized_fptr> f = +[]{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         // Func ptr:
         std::cerr << "\nplain fptr: " << vx::timeit([&]{
             void (*f)() = +[]{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         int flag = 0;
         // std::cin >> flag;
         std::cerr << "\nplain fptr + branch: " << vx::timeit([&]{
             void (*f)() = +[]{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
+                vx::time::do_not_optimize(flag);
                 if (flag == 0) f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
     }
 
 
     /// Micro bench for non-ptr callables:
     {
-        std::cerr << "\n\nBenchmarking non-ptr callables:";
+        std::cerr << "\n\nBenchmarking non-ptr callables (cycles/call):";
         constexpr std::size_t N = 1'000'000;
         constexpr vx::cfg::function inplace_cfg = {
             .SBO = 8,
@@ -571,8 +1202,6 @@ int main() {
             .movable = true
         };
 
-        using time_units = vx::time::ms;
-
         struct A {
             void operator()() noexcept {}
         };
@@ -581,31 +1210,35 @@ int main() {
         std::cerr << "\nstd::function: " << vx::timeit([&]{
             std::function<void()> f = A{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         // Default
         std::cerr << "\ndefault: " << vx::timeit([&]{
             vx::func<void(), inplace_cfg> f = A{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         std::cerr << "\ndefault (noexcept): " << vx::timeit([&]{
             vx::func<void() noexcept, inplace_cfg> f = A{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
 
         // Optimized
         std::cerr << "\noptimized: " << vx::timeit([&]{
             vx::func<void(), optimized_fptr> f = A{};
             for (std::size_t i = 0; i < N; ++i) {
+                vx::time::do_not_optimize(f);
                 f();
             }
-        }).in<time_units>();
+        }).cycles_per(N);
     }
 }
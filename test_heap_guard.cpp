@@ -0,0 +1,57 @@
+/// vx::no_heap_scope enforcement: built with VX_FUNC_HEAP_GUARD, which test_func.cpp leaves undefined
+///
+///   g++ -std=c++20 test_heap_guard.cpp -o test_heap_guard && ./test_heap_guard
+
+#define VX_FUNC_HEAP_GUARD
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include "func.hpp"
+
+struct Spilling {
+    char padding[64] {};
+    int operator()(int x) const { return x + padding[0]; }
+};
+
+/// Runs make() and checks that it was rejected naming Spilling
+template <typename Make>
+bool rejected(Make make) {
+    try {
+        make();
+    } catch (vx::bad_function_operation const& e) {
+        return std::string{ e.what() }.find("Spilling") != std::string::npos;
+    }
+    return false;
+}
+
+int main() {
+    static_assert(!vx::func<int(int)>::is_sbo_eligible<Spilling>);
+
+    vx::func<int(int)> outside = Spilling{};
+    {
+        vx::no_heap_scope guard;
+
+        /// Inline callables and moves of heap-stored ones don't allocate
+        vx::func<int(int)> small = [](int x) { return x; };
+        auto moved = std::move(outside);
+        assert(small(1) == 1 && moved(1) == 1);
+
+        /// Storing a callable that doesn't fit the SBO, or copying a heap-stored one, is rejected
+        assert(rejected([] { vx::func<int(int)> spilled = Spilling{}; }));
+        assert(rejected([&] { auto copy = moved; }));
+
+        {
+            vx::no_heap_scope nested;
+            assert(rejected([] { vx::func<int(int)> spilled = Spilling{}; }));
+        }
+        assert(rejected([] { vx::func<int(int)> spilled = Spilling{}; })); ///< still inside the outer scope
+    }
+
+    /// Allowed again once every scope has ended
+    vx::func<int(int)> allowed = Spilling{};
+    auto copy = allowed;
+    assert(allowed(1) == 1 && copy(2) == 2);
+
+    std::puts("heap guard: ok");
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+/// Executable trampolines: export a vx::func as a plain C function pointer without a context argument
+/// (qsort-style comparators, legacy signal handlers and plugin ABIs).
+///
+///     vx::thunk<int(const void*, const void*)> cmp = [&](const void* a, const void* b) { ++calls; return ...; };
+///     std::qsort(data, n, size, cmp.get());
+///
+/// Linux x86-64 / AArch64 only (VX_HAS_THUNKS). Thunks are carved out of mmap'd chunks:
+/// a code page (read+exec, written once when the chunk is created) followed by a data page
+/// holding {context, entry} per slot. A thunk shifts the integer argument registers by one,
+/// loads its context into the first one and jumps to entry(context, args...), so binding
+/// a slot is two atomic stores and no code is ever rewritten. Slots are recycled through
+/// a lock-free free list; chunks are never unmapped.
+///
+/// Signature restrictions (the argument shift has to be ABI-transparent): arguments and the result
+/// are scalars (integral, enum, pointer, reference, float, double), with at most 5 (x86-64) / 7 (AArch64)
+/// integer-class arguments.
+
+#include <atomic>
+#include <cstdint> // std::uintptr_t
+#include <cstring> // std::memcpy
+#include <type_traits>
+#include <utility>
+#include "func.hpp"
+
+#if defined __linux__ && (defined __x86_64__ || defined __aarch64__)
+    #define VX_HAS_THUNKS 1
+    #include <sys/mman.h>
+    #include <unistd.h>
+#else
+    #define VX_HAS_THUNKS 0
+#endif
+
+#if VX_HAS_THUNKS
+
+namespace vx {
+
+namespace detail {
+
+class thunk_pool {
+public:
+    /// Per-slot data read by the thunk code
+    struct binding {
+        std::atomic<std::uintptr_t> context; ///< or the next free slot while on the free list
+        std::atomic<std::uintptr_t> entry;
+    };
+
+#if defined __x86_64__
+    static constexpr std::size_t code_size = 32;
+    static constexpr std::size_t max_integer_args = 5; ///< rdi..r9, one taken by the context
+#else
+    static constexpr std::size_t code_size = 64;
+    static constexpr std::size_t max_integer_args = 7; ///< x0..x7, one taken by the context
+#endif
+    static constexpr std::size_t max_chunks = 4096;
+
+    static thunk_pool& instance() {
+        static thunk_pool pool;
+        return pool;
+    }
+
+    /// Returns a slot index, binding is left to the caller
+    std::uint32_t acquire() {
+        auto head = free_head.load(std::memory_order_acquire);
+        while (index_of(head) != empty) {
+            const auto next = static_cast<std::uint32_t>(slot(index_of(head)).context.load(std::memory_order_relaxed));
+            if (free_head.compare_exchange_weak(head, tagged(next, tag_of(head) + 1),
+                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return index_of(head);
+            }
+        }
+        return grow();
+    }
+
+    void release(std::uint32_t index) noexcept {
+        slot(index).entry.store(0, std::memory_order_relaxed);
+        push(index);
+    }
+
+    binding& slot(std::uint32_t index) noexcept {
+        auto * chunk = chunks[index / slots_per_chunk].load(std::memory_order_acquire);
+        return reinterpret_cast<binding*>(chunk + code_bytes)[index % slots_per_chunk];
+    }
+
+    void * code(std::uint32_t index) noexcept {
+        auto * chunk = chunks[index / slots_per_chunk].load(std::memory_order_acquire);
+        return chunk + (index % slots_per_chunk) * code_size;
+    }
+
+private:
+    static constexpr std::uint32_t empty = ~std::uint32_t{0};
+
+    /// Free list head: slot index in the low half, ABA tag in the high half
+    static constexpr std::uint64_t tagged(std::uint32_t index, std::uint64_t tag) noexcept { return (tag << 32) | index; }
+    static constexpr std::uint32_t index_of(std::uint64_t head) noexcept { return static_cast<std::uint32_t>(head); }
+    static constexpr std::uint64_t tag_of(std::uint64_t head) noexcept { return head >> 32; }
+
+    thunk_pool()
+    : page_size{ static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) }
+    , code_bytes{ page_size }
+    , slots_per_chunk{ static_cast<std::uint32_t>(page_size / code_size) }
+    , data_bytes{ (slots_per_chunk * sizeof(binding) + page_size - 1) / page_size * page_size }
+    {}
+
+    void push(std::uint32_t index) noexcept {
+        auto head = free_head.load(std::memory_order_relaxed);
+        do {
+            slot(index).context.store(index_of(head), std::memory_order_relaxed);
+        } while (!free_head.compare_exchange_weak(head, tagged(index, tag_of(head) + 1),
+                    std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /// Maps a new chunk, keeps its first slot and puts the rest on the free list
+    std::uint32_t grow() {
+        const auto chunk_index = chunk_count.fetch_add(1, std::memory_order_relaxed);
+        if (chunk_index >= max_chunks) { throw bad_function_operation{"thunk pool exhausted"}; }
+
+        void * mem = mmap(nullptr, code_bytes + data_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) { throw bad_function_operation{"cannot map thunk memory"}; }
+        auto * chunk = static_cast<std::byte*>(mem);
+
+        for (std::uint32_t i = 0; i < slots_per_chunk; ++i) {
+            write_code(chunk + i * code_size, chunk + code_bytes + i * sizeof(binding));
+        }
+        if (mprotect(chunk, code_bytes, PROT_READ | PROT_EXEC) != 0) {
+            munmap(mem, code_bytes + data_bytes);
+            throw bad_function_operation{"cannot make thunk memory executable"};
+        }
+        __builtin___clear_cache(reinterpret_cast<char*>(chunk), reinterpret_cast<char*>(chunk + code_bytes));
+
+        chunks[chunk_index].store(chunk, std::memory_order_release);
+        const auto first = chunk_index * slots_per_chunk;
+        for (std::uint32_t i = 1; i < slots_per_chunk; ++i) { push(first + i); }
+        return first;
+    }
+
+    static void write_code(std::byte * code, std::byte * data) noexcept {
+        const auto context_addr = reinterpret_cast<std::intptr_t>(data) + std::intptr_t(offsetof(binding, context));
+        const auto entry_addr = reinterpret_cast<std::intptr_t>(data) + std::intptr_t(offsetof(binding, entry));
+#if defined __x86_64__
+        const std::uint8_t shift[] = {
+            0x4D, 0x89, 0xC1, // mov r9, r8
+            0x49, 0x89, 0xC8, // mov r8, rcx
+            0x48, 0x89, 0xD1, // mov rcx, rdx
+            0x48, 0x89, 0xF2, // mov rdx, rsi
+            0x48, 0x89, 0xFE, // mov rsi, rdi
+        };
+        auto * p = reinterpret_cast<std::uint8_t*>(code);
+        std::memcpy(p, shift, sizeof(shift));
+        p += sizeof(shift);
+
+        // mov rdi, [rip + context]
+        const auto rel_context = static_cast<std::int32_t>(context_addr - (reinterpret_cast<std::intptr_t>(p) + 7));
+        *p++ = 0x48; *p++ = 0x8B; *p++ = 0x3D;
+        std::memcpy(p, &rel_context, 4);
+        p += 4;
+
+        // jmp [rip + entry]
+        const auto rel_entry = static_cast<std::int32_t>(entry_addr - (reinterpret_cast<std::intptr_t>(p) + 6));
+        *p++ = 0xFF; *p++ = 0x25;
+        std::memcpy(p, &rel_entry, 4);
+#else
+        const auto pc = reinterpret_cast<std::intptr_t>(code);
+        const auto ldr_literal = [&](std::uint32_t rt, std::intptr_t at, std::intptr_t target) {
+            return 0x58000000u | ((static_cast<std::uint32_t>((target - (pc + at)) / 4) & 0x7FFFFu) << 5) | rt;
+        };
+        const std::uint32_t insns[] = {
+            0xAA0603E7, // mov x7, x6
+            0xAA0503E6, // mov x6, x5
+            0xAA0403E5, // mov x5, x4
+            0xAA0303E4, // mov x4, x3
+            0xAA0203E3, // mov x3, x2
+            0xAA0103E2, // mov x2, x1
+            0xAA0003E1, // mov x1, x0
+            ldr_literal(0, 28, context_addr), // ldr x0, context
+            ldr_literal(16, 32, entry_addr), // ldr x16, entry
+            0xD61F0200, // br x16
+        };
+        std::memcpy(code, insns, sizeof(insns));
+#endif
+    }
+
+    const std::size_t page_size;
+    const std::size_t code_bytes;
+    const std::uint32_t slots_per_chunk;
+    const std::size_t data_bytes;
+
+    std::atomic<std::uint64_t> free_head { tagged(empty, 0) };
+    std::atomic<std::uint32_t> chunk_count { 0 };
+    std::atomic<std::byte*> chunks [max_chunks] {};
+};
+
+/// Passed in one register: references, and integers, enums, pointers, float and double of at most pointer size
+/// (no __int128, which takes a register pair)
+template <typename T>
+constexpr bool is_thunk_scalar = std::is_reference_v<T>
+                              || ((std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>
+                                   || std::is_same_v<T, float> || std::is_same_v<T, double>) && sizeof(T) <= sizeof(void*));
+
+template <typename T>
+constexpr std::size_t is_integer_class = (std::is_same_v<T, float> || std::is_same_v<T, double>) ? 0 : 1;
+
+} // namespace detail
+
+
+template <typename Signature, cfg::function cfg = cfg::function{}>
+class thunk;
+
+/// @brief Owns a vx::func and an executable thunk calling it; get() is a plain R(*)(Args...)
+///        valid for the lifetime of the thunk object (moves keep the pointer; a moved-from thunk's get() is nullptr)
+template <typename R, typename... Args, cfg::function cfg>
+class thunk<R(Args...), cfg> {
+    static_assert(std::is_void_v<R> || detail::is_thunk_scalar<R>, "thunk results have to be scalars");
+    static_assert((detail::is_thunk_scalar<Args> && ...), "thunk arguments have to be scalars");
+    static_assert((detail::is_integer_class<Args> + ... + 0) <= detail::thunk_pool::max_integer_args,
+        "too many integer arguments for a register-only thunk");
+
+    using function = vx::func<R(Args...), cfg>;
+
+    static R entry(function * self, Args... args) {
+        return (*self)(std::forward<Args>(args)...);
+    }
+
+public:
+    using pointer = R (*)(Args...);
+
+    template <typename F>
+    explicit thunk(F && callable) requires (std::is_constructible_v<function, F&&>)
+    : func{ std::forward<F>(callable) }
+    , index{ detail::thunk_pool::instance().acquire() }
+    {
+        bind();
+    }
+
+    thunk(thunk && other) requires (cfg.movable)
+    : func{ std::move(other.func) }
+    , index{ std::exchange(other.index, no_slot) }
+    {
+        if (index != no_slot) { bind(); }
+    }
+
+    thunk& operator= (thunk && other) = delete;
+    thunk(thunk const&) = delete;
+    thunk& operator= (thunk const&) = delete;
+
+    ~thunk() {
+        if (index != no_slot) { detail::thunk_pool::instance().release(index); }
+    }
+
+    pointer get() const noexcept {
+        if (index == no_slot) { return nullptr; }
+        return reinterpret_cast<pointer>(detail::thunk_pool::instance().code(index));
+    }
+
+    operator pointer() const noexcept { return get(); }
+
+private:
+    static constexpr std::uint32_t no_slot = ~std::uint32_t{0};
+
+    void bind() noexcept {
+        auto& slot = detail::thunk_pool::instance().slot(index);
+        slot.context.store(reinterpret_cast<std::uintptr_t>(&func), std::memory_order_relaxed);
+        slot.entry.store(reinterpret_cast<std::uintptr_t>(&entry), std::memory_order_release);
+    }
+
+    function func;
+    std::uint32_t index;
+};
+
+} // namespace vx
+
+#endif // VX_HAS_THUNKS
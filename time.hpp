@@ -0,0 +1,194 @@
+#pragma once
+
+/// Low-overhead timing for micro benchmarks.
+///
+///     auto m = vx::timeit([&]{ for (std::size_t i = 0; i < N; ++i) f(); });
+///     m.in<vx::time::us>();  ///< total time
+///     m.cycles() / N;        ///< TSC cycles per call
+///
+/// Inside the loop, pass the callable (and its result) to vx::time::do_not_optimize so that the calls survive
+/// optimization: `vx::time::do_not_optimize(f); auto r = f(); vx::time::do_not_optimize(r);`
+///
+/// On x86-64 the time stamp counter is read with serializing fences (lfence; rdtsc / rdtscp; lfence), on AArch64
+/// the virtual counter (isb; cntvct_el0), elsewhere clock_gettime/steady_clock with one tick per nanosecond.
+/// The tick rate is calibrated once against steady_clock and the cost of an empty start/stop pair is subtracted.
+/// Note that TSC cycles are reference cycles at a constant rate, not core clock cycles under turbo/scaling.
+
+#include <algorithm> // std::min
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory> // std::addressof
+#include <utility>
+
+#if defined _MSC_VER
+    #include <intrin.h> // __rdtsc, _ReadWriteBarrier
+#elif defined __x86_64__
+    #include <x86intrin.h>
+#endif
+
+namespace vx {
+
+namespace time {
+
+using ns = std::chrono::nanoseconds;
+using us = std::chrono::microseconds;
+using ms = std::chrono::milliseconds;
+using s = std::chrono::seconds;
+
+/// Raw counter access
+struct counter {
+    /// Unfenced read, cheapest but may be reordered with the surrounding code (tracing timestamps)
+    static std::uint64_t now() noexcept {
+#if defined __x86_64__ || defined _M_X64
+        return __rdtsc();
+#elif defined __aarch64__
+        std::uint64_t t;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+        return t;
+#else
+        return fallback();
+#endif
+    }
+
+    /// Read before the measured region: earlier instructions retire first, later ones don't start early
+    static std::uint64_t start() noexcept {
+#if defined __x86_64__ || defined _M_X64
+        _mm_lfence();
+        const auto t = __rdtsc();
+        _mm_lfence();
+        return t;
+#elif defined __aarch64__
+        std::uint64_t t;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(t) :: "memory");
+        return t;
+#else
+        return fallback();
+#endif
+    }
+
+    /// Read after the measured region: waits for it to complete
+    static std::uint64_t stop() noexcept {
+#if defined __x86_64__ || defined _M_X64
+        unsigned int aux;
+        const auto t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+#elif defined __aarch64__
+        std::uint64_t t;
+        asm volatile("isb; mrs %0, cntvct_el0; isb" : "=r"(t) :: "memory");
+        return t;
+#else
+        return fallback();
+#endif
+    }
+
+    /// Counter ticks per nanosecond, calibrated once against steady_clock (~10ms)
+    static double ticks_per_ns() noexcept {
+        static const double rate = calibrate();
+        return rate;
+    }
+
+    /// Cost of an empty start()/stop() pair in ticks (minimum of many samples)
+    static std::uint64_t overhead() noexcept {
+        static const std::uint64_t ticks = [] {
+            auto best = std::numeric_limits<std::uint64_t>::max();
+            for (int i = 0; i < 1000; ++i) {
+                const auto t0 = start();
+                const auto t1 = stop();
+                best = std::min(best, t1 - t0);
+            }
+            return best;
+        }();
+        return ticks;
+    }
+
+private:
+    static std::uint64_t fallback() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<ns>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static double calibrate() noexcept {
+#if defined __x86_64__ || defined _M_X64 || defined __aarch64__
+        using clock = std::chrono::steady_clock;
+        const auto c0 = clock::now();
+        const auto t0 = start();
+        while (clock::now() - c0 < ms{10}) {}
+        const auto t1 = stop();
+        const auto c1 = clock::now();
+        return double(t1 - t0) / double(std::chrono::duration_cast<ns>(c1 - c0).count());
+#else
+        return 1.0;
+#endif
+    }
+};
+
+/// Makes the optimizer assume that value is read and modified here: keeps a benchmarked callable from being
+/// inlined, hoisted or removed (call it on the callable inside the loop) and a result from being discarded
+template <typename T>
+inline void do_not_optimize(T& value) noexcept {
+#if defined __GNUC__ // GCC, Clang
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(*static_cast<T volatile*>(std::addressof(value)));
+    _ReadWriteBarrier();
+#endif
+}
+
+/// Makes the optimizer assume that all memory is read and written here (pending stores have to happen)
+inline void clobber() noexcept {
+#if defined __GNUC__ // GCC, Clang
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+/// Result of timeit: counter ticks with the measurement overhead subtracted
+class measurement {
+public:
+    explicit measurement(std::uint64_t ticks) noexcept : ticks{ ticks } {}
+
+    /// Counter ticks (TSC reference cycles on x86-64)
+    [[nodiscard]] double cycles() const noexcept { return double(ticks); }
+
+    /// Elapsed time as a count of Unit (fractional)
+    template <typename Unit>
+    [[nodiscard]] double in() const noexcept {
+        const double nanoseconds = double(ticks) / counter::ticks_per_ns();
+        return nanoseconds * double(Unit::period::den) / (double(Unit::period::num) * 1e9);
+    }
+
+    /// Same measurement split over n iterations
+    [[nodiscard]] double cycles_per(std::size_t n) const noexcept { return cycles() / double(n); }
+
+private:
+    std::uint64_t ticks;
+};
+
+} // namespace time
+
+/// @brief Times a single run of f
+template <typename F>
+time::measurement timeit(F&& f) {
+    (void)time::counter::ticks_per_ns(); ///< calibrate outside of the measured region
+    const auto overhead = time::counter::overhead();
+    const auto t0 = time::counter::start();
+    std::forward<F>(f)();
+    const auto t1 = time::counter::stop();
+    const auto elapsed = t1 - t0;
+    return time::measurement{ elapsed > overhead ? elapsed - overhead : 0 };
+}
+
+/// @brief Best (minimum) of several runs of f, for noisy machines
+template <typename F>
+time::measurement timeit(std::size_t runs, F&& f) {
+    auto best = timeit(f);
+    for (std::size_t i = 1; i < runs; ++i) {
+        const auto m = timeit(f);
+        if (m.cycles() < best.cycles()) { best = m; }
+    }
+    return best;
+}
+
+} // namespace vx
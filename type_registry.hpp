@@ -0,0 +1,60 @@
+#pragma once
+
+/// Process-wide registry of callable types shared by the invocation trace (VX_FUNC_TRACE) and the flight
+/// recorder: every type gets a dense ID on first use, with its size, alignment and readable name.
+///
+///     const auto id = vx::detail::type_registry::id<F>(vx::detail::type_name<F>());
+///     vx::detail::type_registry::name(id);          ///< "(unknown)" until the entry is complete
+///
+/// Types beyond max_types still get distinct IDs but no entry.
+
+#include <algorithm> // std::min
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace vx::detail::type_registry {
+
+inline constexpr std::size_t max_types = 4096;
+
+struct entry {
+    std::size_t size;
+    std::size_t alignment;
+    std::string_view name;
+    std::atomic<bool> ready {false}; ///< the fields above are written
+};
+
+inline constinit entry types [max_types] {};
+inline std::atomic<std::uint32_t> count {0};
+
+/// ID of F; name is only read on the first call
+template <typename F>
+std::uint32_t id(std::string_view name) noexcept {
+    static const std::uint32_t assigned = [name] {
+        const auto next = count.fetch_add(1, std::memory_order_relaxed);
+        if (next < max_types) {
+            types[next].size = sizeof(F);
+            types[next].alignment = alignof(F);
+            types[next].name = name;
+            types[next].ready.store(true, std::memory_order_release);
+        }
+        return next;
+    }();
+    return assigned;
+}
+
+/// Upper bound of the IDs with an entry; check complete() before reading one
+inline std::size_t size() noexcept {
+    return std::min<std::size_t>(count.load(std::memory_order_relaxed), max_types);
+}
+
+inline bool complete(std::uint32_t id) noexcept {
+    return id < max_types && types[id].ready.load(std::memory_order_acquire);
+}
+
+inline std::string_view name(std::uint32_t id) noexcept {
+    return complete(id) ? types[id].name : std::string_view{"(unknown)"};
+}
+
+} // namespace vx::detail::type_registry